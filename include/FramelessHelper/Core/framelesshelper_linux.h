@@ -120,6 +120,27 @@ using xcb_button_press_event_t = struct xcb_button_press_event_t
 };
 using xcb_button_release_event_t = xcb_button_press_event_t;
 
+using xcb_generic_event_t = struct xcb_generic_event_t
+{
+    uint8_t response_type;
+    uint8_t pad0;
+    uint16_t sequence;
+    uint32_t pad[7];
+    uint32_t full_sequence;
+};
+
+using xcb_property_notify_event_t = struct xcb_property_notify_event_t
+{
+    uint8_t response_type;
+    uint8_t pad0;
+    uint16_t sequence;
+    xcb_window_t window;
+    xcb_atom_t atom;
+    xcb_timestamp_t time;
+    uint8_t state;
+    uint8_t pad1[3];
+};
+
 using xcb_void_cookie_t = struct xcb_void_cookie_t
 {
     unsigned int sequence;
@@ -194,6 +215,9 @@ using xcb_list_properties_reply_t = struct xcb_list_properties_reply_t
 [[maybe_unused]] inline constexpr const auto XCB_BUTTON_INDEX_3 = 3;
 [[maybe_unused]] inline constexpr const auto XCB_BUTTON_RELEASE = 5;
 [[maybe_unused]] inline constexpr const auto XCB_CLIENT_MESSAGE = 33;
+[[maybe_unused]] inline constexpr const auto XCB_PROPERTY_NOTIFY = 28;
+[[maybe_unused]] inline constexpr const auto XCB_PROPERTY_NEW_VALUE = 0;
+[[maybe_unused]] inline constexpr const auto XCB_PROPERTY_DELETE = 1;
 [[maybe_unused]] inline constexpr const auto XCB_EVENT_MASK_STRUCTURE_NOTIFY = 131072;
 [[maybe_unused]] inline constexpr const auto XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT = 1048576;
 [[maybe_unused]] inline constexpr const auto XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY = 524288;
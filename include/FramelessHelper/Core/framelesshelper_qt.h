@@ -25,6 +25,7 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <memory>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -40,9 +41,13 @@ public:
     explicit FramelessHelperQt(QObject *parent = nullptr);
     ~FramelessHelperQt() override;
 
-    static void addWindow(const SystemParameters *params);
+    static void addWindow(const std::shared_ptr<const SystemParameters> &params);
     static void removeWindow(const WId windowId);
 
+    // How many mouse moves didn't need their own cursor update because
+    // Option::EnableMouseMoveCoalescing merged them into a later one.
+    Q_NODISCARD static quint64 coalescedMouseMoveCount();
+
 protected:
     Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
 };
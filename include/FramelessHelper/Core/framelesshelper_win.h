@@ -25,6 +25,7 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <memory>
 #include <QtCore/qabstractnativeeventfilter.h>
 
 #ifdef Q_OS_WINDOWS
@@ -41,7 +42,7 @@ public:
     explicit FramelessHelperWin();
     ~FramelessHelperWin() override;
 
-    static void addWindow(const SystemParameters *params);
+    static void addWindow(const std::shared_ptr<const SystemParameters> &params);
     static void removeWindow(const WId windowId);
 
     Q_NODISCARD bool nativeEventFilter(const QByteArray &eventType, void *message, QT_NATIVE_EVENT_RESULT_TYPE *result) override;
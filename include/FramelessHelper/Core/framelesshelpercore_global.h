@@ -323,7 +323,11 @@ enum class Option : quint8
     DisableLazyInitializationForMicaMaterial,
     ForceNativeBackgroundBlur,
     WindowUseSquareCorners,
-    Last = WindowUseSquareCorners
+    EnableMicaMaterialSharedMemoryCache,
+    EnableMouseMoveCoalescing,
+    ForceFullChildrenRepaint,
+    EnableMicaMaterialDiskCache,
+    Last = EnableMicaMaterialDiskCache
 };
 Q_ENUM_NS(Option)
 
@@ -481,6 +485,14 @@ enum class WindowCornerStyle : quint8
 };
 Q_ENUM_NS(WindowCornerStyle)
 
+enum class MicaQuality : quint8
+{
+    Fast, // Blur at 1/16 of the screen size.
+    Balanced, // Blur at 1/8 of the screen size.
+    High // Blur at 1/4 of the screen size.
+};
+Q_ENUM_NS(MicaQuality)
+
 struct VersionInfo
 {
     struct {
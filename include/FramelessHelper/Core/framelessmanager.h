@@ -25,6 +25,7 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <memory>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -51,7 +52,7 @@ public:
     Q_NODISCARD Global::WallpaperAspectStyle wallpaperAspectStyle() const;
 
 public Q_SLOTS:
-    void addWindow(const SystemParameters *params);
+    void addWindow(const std::shared_ptr<const SystemParameters> &params);
     void removeWindow(const WId windowId);
     void setOverrideTheme(const Global::SystemTheme theme);
 
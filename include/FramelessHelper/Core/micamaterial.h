@@ -44,6 +44,7 @@ class FRAMELESSHELPER_CORE_API MicaMaterial : public QObject
     Q_PROPERTY(QColor fallbackColor READ fallbackColor WRITE setFallbackColor NOTIFY fallbackColorChanged FINAL)
     Q_PROPERTY(qreal noiseOpacity READ noiseOpacity WRITE setNoiseOpacity NOTIFY noiseOpacityChanged FINAL)
     Q_PROPERTY(bool fallbackEnabled READ isFallbackEnabled WRITE setFallbackEnabled NOTIFY fallbackEnabledChanged FINAL)
+    Q_PROPERTY(Global::MicaQuality quality READ quality WRITE setQuality NOTIFY qualityChanged FINAL)
 
 public:
     explicit MicaMaterial(QObject *parent = nullptr);
@@ -64,6 +65,18 @@ public:
     Q_NODISCARD bool isFallbackEnabled() const;
     void setFallbackEnabled(const bool value);
 
+    Q_NODISCARD Global::MicaQuality quality() const;
+    void setQuality(const Global::MicaQuality value);
+
+    // The number of threads used to blur the wallpaper, shared by all instances.
+    // Zero or less means one thread per available CPU core, which is the default.
+    Q_NODISCARD static int blurThreadCount();
+    static void setBlurThreadCount(const int value);
+
+    // How many times painting happened while the wallpaper was being blurred. Painting
+    // no longer waits for the blur, it used to be blocked until the blur was done.
+    Q_NODISCARD static quint64 contendedPaintCount();
+
 public Q_SLOTS:
     void paint(QPainter *painter, const QRect &rect, const bool active = true);
 
@@ -79,6 +92,7 @@ Q_SIGNALS:
     void fallbackColorChanged();
     void noiseOpacityChanged();
     void fallbackEnabledChanged();
+    void qualityChanged();
     void shouldRedraw();
 
 private:
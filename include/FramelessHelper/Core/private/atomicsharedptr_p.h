@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <atomic>
+#include <memory>
+
+#if (defined(__cpp_lib_atomic_shared_ptr) && (__cpp_lib_atomic_shared_ptr >= 201711L))
+#  define FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR
+#elif (__cplusplus <= 202302L)
+// Deprecated in C++20 and removed in C++26, but every library that doesn't have
+// std::atomic<std::shared_ptr<T>> yet still provides them.
+#  define FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR_FUNCTIONS
+#else
+#  include <QtCore/qmutex.h>
+#endif
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+/*
+    A shared pointer that can be loaded and replaced from any thread, used to
+    publish immutable snapshots. It's std::atomic<std::shared_ptr<T>> where the
+    standard library provides it, the free std::atomic_load()/std::atomic_store()
+    overloads otherwise, and a mutex only if neither of them is available.
+*/
+template<typename T>
+class AtomicSharedPtr
+{
+    Q_DISABLE_COPY_MOVE(AtomicSharedPtr)
+
+public:
+    using Pointer = std::shared_ptr<T>;
+
+    AtomicSharedPtr() = default;
+    explicit AtomicSharedPtr(Pointer value) : m_value(std::move(value)) {}
+    ~AtomicSharedPtr() = default;
+
+    [[nodiscard]] Pointer load() const
+    {
+#if defined(FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR)
+        return m_value.load(std::memory_order_acquire);
+#elif defined(FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR_FUNCTIONS)
+        QT_WARNING_PUSH
+        QT_WARNING_DISABLE_DEPRECATED
+        return std::atomic_load_explicit(&m_value, std::memory_order_acquire);
+        QT_WARNING_POP
+#else
+        const QMutexLocker locker(&m_mutex);
+        return m_value;
+#endif
+    }
+
+    void store(Pointer value)
+    {
+#if defined(FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR)
+        m_value.store(std::move(value), std::memory_order_release);
+#elif defined(FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR_FUNCTIONS)
+        QT_WARNING_PUSH
+        QT_WARNING_DISABLE_DEPRECATED
+        std::atomic_store_explicit(&m_value, std::move(value), std::memory_order_release);
+        QT_WARNING_POP
+#else
+        {
+            const QMutexLocker locker(&m_mutex);
+            m_value.swap(value);
+        }
+        // The previous snapshot (now in "value") is released outside of the lock.
+#endif
+    }
+
+private:
+#ifdef FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR
+    std::atomic<Pointer> m_value{};
+#else // !FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR
+    Pointer m_value = nullptr;
+#  ifndef FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR_FUNCTIONS
+    mutable QMutex m_mutex{};
+#  endif // FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR_FUNCTIONS
+#endif // FRAMELESSHELPER_HAS_ATOMIC_SHARED_PTR
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -26,6 +26,7 @@
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
 #include <functional>
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 class QScreen;
@@ -33,71 +34,69 @@ QT_END_NAMESPACE
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
-using GetWindowFlagsCallback = std::function<Qt::WindowFlags()>;
-using SetWindowFlagsCallback = std::function<void(const Qt::WindowFlags)>;
-using GetWindowSizeCallback = std::function<QSize()>;
-using SetWindowSizeCallback = std::function<void(const QSize &)>;
-using GetWindowPositionCallback = std::function<QPoint()>;
-using SetWindowPositionCallback = std::function<void(const QPoint &)>;
-using GetWindowScreenCallback = std::function<QScreen *()>;
-using IsWindowFixedSizeCallback = std::function<bool()>;
-using SetWindowFixedSizeCallback = std::function<void(const bool)>;
-using GetWindowStateCallback = std::function<Qt::WindowState()>;
-using SetWindowStateCallback = std::function<void(const Qt::WindowState)>;
-using GetWindowHandleCallback = std::function<QWindow *()>;
-using WindowToScreenCallback = std::function<QPoint(const QPoint &)>;
-using ScreenToWindowCallback = std::function<QPoint(const QPoint &)>;
-using IsInsideSystemButtonsCallback = std::function<bool(const QPoint &, Global::SystemButtonType *)>;
-using IsInsideTitleBarDraggableAreaCallback = std::function<bool(const QPoint &)>;
-using GetWindowDevicePixelRatioCallback = std::function<qreal()>;
-using SetSystemButtonStateCallback = std::function<void(const Global::SystemButtonType, const Global::ButtonState)>;
-using GetWindowIdCallback = std::function<WId()>;
-using ShouldIgnoreMouseEventsCallback = std::function<bool(const QPoint &)>;
-using ShowSystemMenuCallback = std::function<void(const QPoint &)>;
-using SetPropertyCallback = std::function<void(const char *, const QVariant &)>;
-using GetPropertyCallback = std::function<QVariant(const char *, const QVariant &)>;
-using SetCursorCallback = std::function<void(const QCursor &)>;
-using UnsetCursorCallback = std::function<void()>;
-using GetWidgetHandleCallback = std::function<QObject *()>;
-using ForceChildrenRepaintCallback = std::function<void(const int)>;
-using ResetQtGrabbedControlCallback = std::function<bool()>;
+#if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
+// Resolves the functions of the system libraries we load at runtime (XCB and GTK) in the
+// background, so that the first drag or theme query doesn't have to. Returns immediately.
+void FramelessHelperPreloadSystemLibraries();
+#endif // Q_OS_LINUX
 
+// Everything the mouse event handling needs to know about a point in the window.
+struct HitTestResult
+{
+    Qt::Edges windowEdges = {};
+    Qt::CursorShape cursorShape = Qt::ArrowCursor;
+    // Only looked up on request, it has to check every system button.
+    Global::SystemButtonType systemButton = Global::SystemButtonType::Unknown;
+    bool insideTitleBarDraggableArea = false;
+    bool shouldIgnoreMouseEvents = false;
+    bool windowFixedSize = false;
+    bool dontOverrideCursor = false;
+    bool dontToggleMaximize = false;
+};
+
+// Implemented once per window by the widgets and quick helpers. Every window only costs
+// one vtable pointer, and the core module shares the same object instead of copying it.
 struct SystemParameters
 {
-    GetWindowFlagsCallback getWindowFlags = nullptr;
-    SetWindowFlagsCallback setWindowFlags = nullptr;
-    GetWindowSizeCallback getWindowSize = nullptr;
-    SetWindowSizeCallback setWindowSize = nullptr;
-    GetWindowPositionCallback getWindowPosition = nullptr;
-    SetWindowPositionCallback setWindowPosition = nullptr;
-    GetWindowScreenCallback getWindowScreen = nullptr;
-    IsWindowFixedSizeCallback isWindowFixedSize = nullptr;
-    SetWindowFixedSizeCallback setWindowFixedSize = nullptr;
-    GetWindowStateCallback getWindowState = nullptr;
-    SetWindowStateCallback setWindowState = nullptr;
-    GetWindowHandleCallback getWindowHandle = nullptr;
-    WindowToScreenCallback windowToScreen = nullptr;
-    ScreenToWindowCallback screenToWindow = nullptr;
-    IsInsideSystemButtonsCallback isInsideSystemButtons = nullptr;
-    IsInsideTitleBarDraggableAreaCallback isInsideTitleBarDraggableArea = nullptr;
-    GetWindowDevicePixelRatioCallback getWindowDevicePixelRatio = nullptr;
-    SetSystemButtonStateCallback setSystemButtonState = nullptr;
-    GetWindowIdCallback getWindowId = nullptr;
-    ShouldIgnoreMouseEventsCallback shouldIgnoreMouseEvents = nullptr;
-    ShowSystemMenuCallback showSystemMenu = nullptr;
-    SetPropertyCallback setProperty = nullptr;
-    GetPropertyCallback getProperty = nullptr;
-    SetCursorCallback setCursor = nullptr;
-    UnsetCursorCallback unsetCursor = nullptr;
-    GetWidgetHandleCallback getWidgetHandle = nullptr;
-    ForceChildrenRepaintCallback forceChildrenRepaint = nullptr;
-    ResetQtGrabbedControlCallback resetQtGrabbedControl = nullptr;
+    virtual ~SystemParameters() = default;
+
+    [[nodiscard]] virtual Qt::WindowFlags getWindowFlags() const = 0;
+    virtual void setWindowFlags(const Qt::WindowFlags flags) const = 0;
+    [[nodiscard]] virtual QSize getWindowSize() const = 0;
+    virtual void setWindowSize(const QSize &size) const = 0;
+    [[nodiscard]] virtual QPoint getWindowPosition() const = 0;
+    virtual void setWindowPosition(const QPoint &pos) const = 0;
+    [[nodiscard]] virtual QScreen *getWindowScreen() const = 0;
+    [[nodiscard]] virtual bool isWindowFixedSize() const = 0;
+    virtual void setWindowFixedSize(const bool value) const = 0;
+    [[nodiscard]] virtual Qt::WindowState getWindowState() const = 0;
+    virtual void setWindowState(const Qt::WindowState state) const = 0;
+    [[nodiscard]] virtual QWindow *getWindowHandle() const = 0;
+    [[nodiscard]] virtual QPoint windowToScreen(const QPoint &pos) const = 0;
+    [[nodiscard]] virtual QPoint screenToWindow(const QPoint &pos) const = 0;
+    [[nodiscard]] virtual bool isInsideSystemButtons(const QPoint &pos, Global::SystemButtonType *button) const = 0;
+    [[nodiscard]] virtual bool isInsideTitleBarDraggableArea(const QPoint &pos) const = 0;
+    [[nodiscard]] virtual qreal getWindowDevicePixelRatio() const = 0;
+    virtual void setSystemButtonState(const Global::SystemButtonType button, const Global::ButtonState state) const = 0;
+    [[nodiscard]] virtual WId getWindowId() const = 0;
+    [[nodiscard]] virtual bool shouldIgnoreMouseEvents(const QPoint &pos) const = 0;
+    virtual void showSystemMenu(const QPoint &pos) const = 0;
+    virtual void setProperty(const char *name, const QVariant &value) const = 0;
+    [[nodiscard]] virtual QVariant getProperty(const char *name, const QVariant &defaultValue) const = 0;
+    virtual void setCursor(const QCursor &cursor) const = 0;
+    virtual void unsetCursor() const = 0;
+    [[nodiscard]] virtual QObject *getWidgetHandle() const = 0;
+    virtual void forceChildrenRepaint(const int delay) const = 0;
+    virtual bool resetQtGrabbedControl() const = 0;
+    // Answers all the questions above about one point at once, to save some work for every mouse event.
+    [[nodiscard]] virtual HitTestResult hitTest(const QPoint &pos, const bool querySystemButton) const = 0;
 };
 
 using FramelessParams = SystemParameters *;
 using FramelessParamsConst = const SystemParameters *;
 using FramelessParamsRef = SystemParameters &;
 using FramelessParamsConstRef = const SystemParameters &;
+using FramelessParamsShared = std::shared_ptr<const SystemParameters>;
 
 FRAMELESSHELPER_END_NAMESPACE
 
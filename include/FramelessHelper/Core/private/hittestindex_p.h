@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qrect.h>
+#include <QtCore/qlist.h>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// A uniform grid of columns over the title bar, each column knows the rects that
+// overlap it, so a point query only looks at the rects near that point instead of
+// all of them. Title bars are wide and short, splitting the width is enough.
+class HitTestIndex
+{
+public:
+    HitTestIndex() = default;
+
+    explicit HitTestIndex(const QRect &area, const QList<QRect> &rects)
+    {
+        if (!area.isValid()) {
+            return;
+        }
+        m_area = area;
+        if (rects.isEmpty()) {
+            return;
+        }
+        // One column per rect on average, but not narrower than a few pixels.
+        const int columnCount = std::clamp(int(rects.size()), 1, std::clamp(area.width() / kMinimumColumnWidth, 1, kMaximumColumnCount));
+        m_columnWidth = ((area.width() + columnCount - 1) / columnCount);
+        m_columns.resize(columnCount);
+        for (auto &&rect : std::as_const(rects)) {
+            // QRect::intersected() normalizes the rect first, QRegion ignores such rects.
+            if (rect.isEmpty()) {
+                continue;
+            }
+            const QRect clippedRect = rect.intersected(m_area);
+            if (!clippedRect.isValid()) {
+                continue;
+            }
+            const int first = columnOf(clippedRect.left());
+            const int last = columnOf(clippedRect.right());
+            for (int column = first; column <= last; ++column) {
+                m_columns[column].push_back(clippedRect);
+            }
+        }
+    }
+
+    [[nodiscard]] QRect area() const
+    {
+        return m_area;
+    }
+
+    // Whether the point is inside the area but not covered by any of the rects.
+    [[nodiscard]] bool isInFreeArea(const QPoint &pos) const
+    {
+        if (!m_area.contains(pos)) {
+            return false;
+        }
+        if (m_columns.empty()) {
+            return true;
+        }
+        const std::vector<QRect> &column = m_columns.at(columnOf(pos.x()));
+        return std::none_of(column.cbegin(), column.cend(), [&pos](const QRect &rect){ return rect.contains(pos); });
+    }
+
+private:
+    [[nodiscard]] int columnOf(const int x) const
+    {
+        return std::clamp(((x - m_area.left()) / m_columnWidth), 0, int(m_columns.size() - 1));
+    }
+
+private:
+    static constexpr const int kMinimumColumnWidth = 8;
+    static constexpr const int kMaximumColumnCount = 256;
+
+    QRect m_area = {};
+    int m_columnWidth = 1;
+    std::vector<std::vector<QRect>> m_columns = {};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -27,6 +27,11 @@
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
 #include <QtGui/qbrush.h>
 
+QT_BEGIN_NAMESPACE
+class QScreen;
+class QImage;
+QT_END_NAMESPACE
+
 #if FRAMELESSHELPER_CONFIG(mica_material)
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
@@ -49,16 +54,18 @@ public:
 
     Q_NODISCARD static QColor systemFallbackColor();
 
-    Q_NODISCARD QPoint mapToWallpaper(const QPoint &pos) const;
-    Q_NODISCARD QSize mapToWallpaper(const QSize &size) const;
-    Q_NODISCARD QRect mapToWallpaper(const QRect &rect) const;
+    Q_NODISCARD static QScreen *findScreen(const QRect &rect);
+    Q_NODISCARD static QRect mapToWallpaper(const QScreen *screen, const QRect &rect);
+
+    // Run the same blur as the wallpaper thread, only meant for the benchmarks.
+    Q_NODISCARD static QImage blurredImage(const QImage &image, const qreal radius, const bool transposed = false);
+    Q_NODISCARD static QImage blurredWallpaper(const QImage &image, const int scaleFactor);
 
-    Q_SLOT void maybeGenerateBlurredWallpaper(const bool force = false);
+    void maybeGenerateBlurredWallpaper(const QScreen *screen, const bool force = false);
     Q_SLOT void updateMaterialBrush();
     Q_SLOT void forceRebuildWallpaper();
 
     void initialize();
-    void prepareGraphicsResources();
 
     MicaMaterial *q_ptr = nullptr;
     QColor tintColor = {};
@@ -66,9 +73,9 @@ public:
     QColor fallbackColor = {};
     qreal noiseOpacity = qreal(0);
     bool fallbackEnabled = true;
+    Global::MicaQuality quality = Global::MicaQuality::Balanced;
     QBrush micaBrush = {};
     bool initialized = false;
-    QSize wallpaperSize = {};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -25,6 +25,8 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qbytearraylist.h>
+#include <array>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -46,6 +48,9 @@ public:
 
     Q_NODISCARD bool isAvailable(const QString &library, const QString &function);
 
+    bool preload(const QString &library, const QByteArrayList &functions);
+    void preloadAsync(const QString &library, const QByteArrayList &functions);
+
     Q_NODISCARD QFunctionPointer get(const QString &library, const QString &function);
 
     template<typename T>
@@ -59,6 +64,54 @@ private:
     ~SysApiLoader() override;
 };
 
+// A fixed set of functions from one library, resolved once when the table is created.
+// Looking a function up afterwards is just indexing an array, no strings are involved.
+template<typename Symbol, std::size_t Count>
+class SysApiSymbolTable
+{
+    Q_DISABLE_COPY_MOVE(SysApiSymbolTable)
+
+public:
+    using Names = std::array<const char *, Count>;
+
+    explicit SysApiSymbolTable(const QString &library, const Names &names)
+    {
+        Q_ASSERT(!library.isEmpty());
+        SysApiLoader * const loader = SysApiLoader::instance();
+        QByteArrayList functions = {};
+        functions.reserve(Count);
+        for (auto &&name : names) {
+            functions.append(QByteArray(name));
+        }
+        loader->preload(library, functions);
+        for (std::size_t index = 0; index != Count; ++index) {
+            m_symbols[index] = loader->get(library, QString::fromLatin1(names[index]));
+        }
+    }
+    ~SysApiSymbolTable() = default;
+
+    Q_NODISCARD bool isAvailable(const Symbol symbol) const
+    {
+        return (get(symbol) != nullptr);
+    }
+
+    Q_NODISCARD QFunctionPointer get(const Symbol symbol) const
+    {
+        const auto index = static_cast<std::size_t>(symbol);
+        Q_ASSERT(index < Count);
+        return m_symbols[index];
+    }
+
+    template<typename T>
+    Q_NODISCARD T get(const Symbol symbol) const
+    {
+        return reinterpret_cast<T>(get(symbol));
+    }
+
+private:
+    std::array<QFunctionPointer, Count> m_symbols = {};
+};
+
 FRAMELESSHELPER_END_NAMESPACE
 
 #define API_AVAILABLE(lib, func) \
@@ -77,6 +130,28 @@ FRAMELESSHELPER_END_NAMESPACE
 
 #define API_CALL_FUNCTION5(lib, func, ...) API_CALL_FUNCTION3(lib, func##2, func, __VA_ARGS__)
 
+#define API_SYMBOL_TABLE_ENTRY(func) func,
+#define API_SYMBOL_TABLE_NAME(func) #func,
+
+// "list" is an X macro which expands its argument once for every function of the library.
+#define API_DECLARE_SYMBOL_TABLE(lib, list) \
+  enum class lib##Symbol : quint16 { list(API_SYMBOL_TABLE_ENTRY) }; \
+  [[nodiscard]] static inline const auto &lib##Symbols() \
+  { \
+      static constexpr const std::array kNames = { list(API_SYMBOL_TABLE_NAME) }; \
+      static const FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiSymbolTable)<lib##Symbol, kNames.size()> symbols(k##lib, kNames); \
+      return symbols; \
+  }
+
+// Resolves the whole table on a background thread, so that creating it later only hits the cache.
+#define API_PRELOAD_SYMBOL_TABLE(lib, list) \
+  FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->preloadAsync(k##lib, { list(API_SYMBOL_TABLE_NAME) })
+
+#define API_SYMBOL_AVAILABLE(lib, func) (lib##Symbols().isAvailable(lib##Symbol::func))
+
+#define API_SYMBOL_CALL_FUNCTION(lib, func, ...) \
+  ((lib##Symbols().get<decltype(&func)>(lib##Symbol::func))(__VA_ARGS__))
+
 #ifdef Q_OS_WINDOWS
 #  define API_USER_AVAILABLE(func) API_AVAILABLE(user32, func)
 #  define API_THEME_AVAILABLE(func) API_AVAILABLE(uxtheme, func)
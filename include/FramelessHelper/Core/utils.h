@@ -25,6 +25,7 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <memory>
 #if (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
 #  include <FramelessHelper/Core/framelesshelper_linux.h>
 #endif // Q_OS_LINUX
@@ -124,7 +125,7 @@ FRAMELESSHELPER_CORE_API void moveWindowToDesktopCenter(
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool isWindowFrameBorderVisible();
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool isFrameBorderColorized();
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool installWindowProcHook(
-    const WId windowId, const SystemParameters *params);
+    const WId windowId, const std::shared_ptr<const SystemParameters> &params);
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool uninstallWindowProcHook(const WId windowId);
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool setAeroSnappingEnabled(const WId windowId, const bool enable);
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool tryToEnableHighestDpiAwarenessLevel();
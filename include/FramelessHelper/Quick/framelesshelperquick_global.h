@@ -138,6 +138,14 @@ public:
     };
     Q_ENUM(BlurMode)
 
+    enum class MicaQuality : quint8
+    {
+        FRAMELESSHELPER_QUICK_ENUM_VALUE(MicaQuality, Fast)
+        FRAMELESSHELPER_QUICK_ENUM_VALUE(MicaQuality, Balanced)
+        FRAMELESSHELPER_QUICK_ENUM_VALUE(MicaQuality, High)
+    };
+    Q_ENUM(MicaQuality)
+
     enum class WindowEdge : quint8
     {
         FRAMELESSHELPER_QUICK_ENUM_VALUE(WindowEdge, Left)
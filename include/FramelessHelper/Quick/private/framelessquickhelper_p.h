@@ -25,10 +25,13 @@
 #pragma once
 
 #include <FramelessHelper/Quick/framelesshelperquick_global.h>
+#include <QtCore/qpointer.h>
 #include <optional>
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 class QQuickItem;
+class QQuickWindow;
 QT_END_NAMESPACE
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
@@ -41,6 +44,8 @@ class QuickWindowBorder;
 #endif
 class FramelessQuickHelper;
 struct FramelessQuickHelperData;
+class HitTestIndex;
+struct HitTestResult;
 
 class FRAMELESSHELPER_QUICK_API FramelessQuickHelperPrivate : public QObject
 {
@@ -74,13 +79,21 @@ public:
     Q_NODISCARD static FramelessQuickHelper *findOrCreateFramelessHelper(QObject *object);
 
     void repaintAllChildren(const quint32 delay = 0) const;
+    void cancelPendingRepaint() const;
 
     Q_NODISCARD quint32 readyWaitTime() const;
     void setReadyWaitTime(const quint32 time);
 
     Q_NODISCARD QRect mapItemGeometryToScene(const QQuickItem * const item) const;
     Q_NODISCARD bool isInSystemButtons(const QPoint &pos, QuickGlobal::SystemButtonType *button) const;
+    Q_NODISCARD bool isInSystemButtons(const FramelessQuickHelperData *data, const QPoint &pos, QuickGlobal::SystemButtonType *button) const;
     Q_NODISCARD bool isInTitleBarDraggableArea(const QPoint &pos) const;
+    Q_NODISCARD bool isInTitleBarDraggableArea(FramelessQuickHelperData *data, const QPoint &pos) const;
+    Q_NODISCARD HitTestResult hitTest(const QPoint &pos, const bool querySystemButton) const;
+    Q_NODISCARD HitTestIndex calculateTitleBarHitTestIndex() const;
+    void invalidateTitleBarHitTestIndex();
+    void watchHitTestItem(QQuickItem *item);
+    void handleHitTestItemParentChanged();
     Q_NODISCARD bool shouldIgnoreMouseEvents(const QPoint &pos) const;
     void setSystemButtonState(const QuickGlobal::SystemButtonType button, const QuickGlobal::ButtonState state);
     Q_NODISCARD const FramelessQuickHelperData *getWindowData() const;
@@ -93,6 +106,10 @@ public:
     std::optional<bool> extendIntoTitleBar = std::nullopt;
     bool qpaReady = false;
     quint32 qpaWaitTime = 0;
+    // The data of the current window, so that it doesn't need to be looked up every time.
+    mutable std::weak_ptr<FramelessQuickHelperData> windowData = {};
+    mutable QPointer<const QQuickWindow> windowDataOwner = nullptr;
+    mutable QMetaObject::Connection repaintConnection = {};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -48,6 +48,7 @@ class FRAMELESSHELPER_QUICK_API QuickMicaMaterial : public QQuickPaintedItem
     Q_PROPERTY(QColor fallbackColor READ fallbackColor WRITE setFallbackColor NOTIFY fallbackColorChanged FINAL)
     Q_PROPERTY(qreal noiseOpacity READ noiseOpacity WRITE setNoiseOpacity NOTIFY noiseOpacityChanged FINAL)
     Q_PROPERTY(bool fallbackEnabled READ isFallbackEnabled WRITE setFallbackEnabled NOTIFY fallbackEnabledChanged FINAL)
+    Q_PROPERTY(QuickGlobal::MicaQuality quality READ quality WRITE setQuality NOTIFY qualityChanged FINAL)
 
 public:
     explicit QuickMicaMaterial(QQuickItem *parent = nullptr);
@@ -70,12 +71,16 @@ public:
     Q_NODISCARD bool isFallbackEnabled() const;
     void setFallbackEnabled(const bool value);
 
+    Q_NODISCARD QuickGlobal::MicaQuality quality() const;
+    void setQuality(const QuickGlobal::MicaQuality value);
+
 Q_SIGNALS:
     void tintColorChanged();
     void tintOpacityChanged();
     void fallbackColorChanged();
     void noiseOpacityChanged();
     void fallbackEnabledChanged();
+    void qualityChanged();
 
 protected:
     void itemChange(const ItemChange change, const ItemChangeData &value) override;
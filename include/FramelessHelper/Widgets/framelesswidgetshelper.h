@@ -54,6 +54,7 @@ public:
     ~FramelessWidgetsHelper() override;
 
     Q_NODISCARD static FramelessWidgetsHelper *get(QObject *object);
+    Q_NODISCARD static QList<FramelessWidgetsHelper *> get(const QList<QWidget *> &windows);
 
     Q_NODISCARD QWidget *titleBarWidget() const;
     Q_NODISCARD bool isWindowFixedSize() const;
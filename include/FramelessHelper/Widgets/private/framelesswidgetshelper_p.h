@@ -27,6 +27,7 @@
 #include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
 #include <QtCore/qvariant.h>
 #include <QtWidgets/qsizepolicy.h>
+#include <memory>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -39,6 +40,8 @@ class WindowBorderPainter;
 class FramelessWidgetsHelper;
 struct FramelessWidgetsHelperData;
 class WidgetsSharedHelper;
+class HitTestIndex;
+struct HitTestResult;
 
 class FRAMELESSHELPER_WIDGETS_API FramelessWidgetsHelperPrivate : public QObject
 {
@@ -71,21 +74,31 @@ public:
 
     Q_NODISCARD static WidgetsSharedHelper *findOrCreateSharedHelper(QWidget *window);
     Q_NODISCARD static FramelessWidgetsHelper *findOrCreateFramelessHelper(QObject *object);
+    Q_NODISCARD static QList<FramelessWidgetsHelper *> findOrCreateFramelessHelpers(const QList<QWidget *> &windows);
 
     void repaintAllChildren(const quint32 delay = 0) const;
 
     Q_NODISCARD quint32 readyWaitTime() const;
     void setReadyWaitTime(const quint32 time);
+    void handleQpaReady();
 
     Q_NODISCARD QRect mapWidgetGeometryToScene(const QWidget * const widget) const;
     Q_NODISCARD bool isInSystemButtons(const QPoint &pos, Global::SystemButtonType *button) const;
+    Q_NODISCARD bool isInSystemButtons(const FramelessWidgetsHelperData *data, const QPoint &pos, Global::SystemButtonType *button) const;
     Q_NODISCARD bool isInTitleBarDraggableArea(const QPoint &pos) const;
+    Q_NODISCARD bool isInTitleBarDraggableArea(FramelessWidgetsHelperData *data, const QPoint &pos) const;
+    Q_NODISCARD HitTestResult hitTest(const QPoint &pos, const bool querySystemButton) const;
+    Q_NODISCARD HitTestIndex calculateTitleBarHitTestIndex() const;
+    void invalidateTitleBarHitTestIndex();
+    void watchHitTestWidget(QWidget *widget);
     Q_NODISCARD bool shouldIgnoreMouseEvents(const QPoint &pos) const;
     void setSystemButtonState(const Global::SystemButtonType button, const Global::ButtonState state);
     Q_NODISCARD QWidget *findTopLevelWindow() const;
     Q_NODISCARD const FramelessWidgetsHelperData *getWindowData() const;
     Q_NODISCARD FramelessWidgetsHelperData *getWindowDataMutable() const;
 
+    Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
+
     FramelessWidgetsHelper *q_ptr = nullptr;
     QColor savedWindowBackgroundColor = {};
     bool blurBehindWindowEnabled = false;
@@ -93,6 +106,8 @@ public:
     bool qpaReady = false;
     QSizePolicy savedSizePolicy = {};
     quint32 qpaWaitTime = 0;
+    // The data of the current window, so that it doesn't need to be looked up every time.
+    mutable std::weak_ptr<FramelessWidgetsHelperData> windowData = {};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
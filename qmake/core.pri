@@ -42,7 +42,9 @@ HEADERS += \
     $$CORE_PRIV_INC_DIR/windowborderpainter_p.h \
     $$CORE_PRIV_INC_DIR/framelesshelpercore_global_p.h \
     $$CORE_PRIV_INC_DIR/versionnumber_p.h \
-    $$CORE_PRIV_INC_DIR/scopeguard_p.h
+    $$CORE_PRIV_INC_DIR/scopeguard_p.h \
+    $$CORE_PRIV_INC_DIR/hittestindex_p.h \
+    $$CORE_PRIV_INC_DIR/atomicsharedptr_p.h
 
 SOURCES += \
     $$CORE_SRC_DIR/chromepalette.cpp \
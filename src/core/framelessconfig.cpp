@@ -66,7 +66,11 @@ static constexpr const std::array<FramelessConfigEntry, static_cast<int>(Option:
     FramelessConfigEntry{ "FRAMELESSHELPER_FORCE_NON_NATIVE_BACKGROUND_BLUR", "Options/ForceNonNativeBackgroundBlur" },
     FramelessConfigEntry{ "FRAMELESSHELPER_DISABLE_LAZY_INITIALIZATION_FOR_MICA_MATERIAL", "Options/DisableLazyInitializationForMicaMaterial" },
     FramelessConfigEntry{ "FRAMELESSHELPER_FORCE_NATIVE_BACKGROUND_BLUR", "Options/ForceNativeBackgroundBlur" },
-    FramelessConfigEntry{ "FRAMELESSHELPER_WINDOW_USE_SQUARE_CORNERS", "Options/WindowUseSquareCorners" }
+    FramelessConfigEntry{ "FRAMELESSHELPER_WINDOW_USE_SQUARE_CORNERS", "Options/WindowUseSquareCorners" },
+    FramelessConfigEntry{ "FRAMELESSHELPER_ENABLE_MICA_MATERIAL_SHARED_MEMORY_CACHE", "Options/EnableMicaMaterialSharedMemoryCache" },
+    FramelessConfigEntry{ "FRAMELESSHELPER_ENABLE_MOUSE_MOVE_COALESCING", "Options/EnableMouseMoveCoalescing" },
+    FramelessConfigEntry{ "FRAMELESSHELPER_FORCE_FULL_CHILDREN_REPAINT", "Options/ForceFullChildrenRepaint" },
+    FramelessConfigEntry{ "FRAMELESSHELPER_ENABLE_MICA_MATERIAL_DISK_CACHE", "Options/EnableMicaMaterialDiskCache" }
 };
 
 static constexpr const auto OptionCount = std::size(FramelessOptionsTable);
@@ -29,8 +29,12 @@
 #include "framelesshelpercore_global_p.h"
 #include "utils.h"
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qpointer.h>
 #include <QtGui/qevent.h>
 #include <QtGui/qwindow.h>
+#include <QtGui/qscreen.h>
+#include <atomic>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -49,23 +53,123 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+[[maybe_unused]] static constexpr const int kDefaultCursorUpdateInterval = 16; // ~60Hz
+
 struct FramelessQtHelperData
 {
-    SystemParameters params = {};
-    FramelessHelperQt *eventFilter = nullptr;
+    FramelessParamsShared params = nullptr;
     bool cursorShapeChanged = false;
     bool leftButtonPressed = false;
+    // Only used if Option::EnableMouseMoveCoalescing is set.
+    QTimer *cursorUpdateTimer = nullptr;
+    bool cursorUpdatePending = false;
+    QPoint pendingCursorPos = {};
 };
 
-using FramelessQtHelperInternal = QHash<WId, FramelessQtHelperData>;
+static inline void flushCursorUpdate(FramelessQtHelperData &data);
+
+// The event filter installed on each window. It owns the data of its window,
+// so handling events needs no lookup at all.
+class FramelessQtWindowFilter final : public FramelessHelperQt
+{
+public:
+    explicit FramelessQtWindowFilter(QWindow *window, const FramelessParamsShared &params) : FramelessHelperQt(window)
+    {
+        m_data.params = params;
+        m_data.cursorUpdateTimer = &m_cursorUpdateTimer;
+        m_cursorUpdateTimer.setSingleShot(true);
+        connect(&m_cursorUpdateTimer, &QTimer::timeout, this, [this](){ flushCursorUpdate(m_data); });
+    }
+    ~FramelessQtWindowFilter() override = default;
+
+    // The owner of the parameters may be destroyed before the deferred deletion
+    // of this filter, so nothing must use them anymore once the window is removed.
+    void release()
+    {
+        m_cursorUpdateTimer.stop();
+        m_data.cursorUpdatePending = false;
+        m_data.params = nullptr;
+    }
+
+protected:
+    [[nodiscard]] bool eventFilter(QObject *object, QEvent *event) override;
+
+private:
+    FramelessQtHelperData m_data = {};
+    QTimer m_cursorUpdateTimer{};
+};
+
+// Only needed to find the event filter of a window when removing it.
+using FramelessQtHelperInternal = QHash<WId, QPointer<FramelessQtWindowFilter>>;
 
 Q_GLOBAL_STATIC(FramelessQtHelperInternal, g_framelessQtHelperData)
 
+// Only a statistic, it may be read from any thread but orders nothing.
+static std::atomic<quint64> g_coalescedMouseMoveCount = 0;
+
+static inline void updateCursorShape(FramelessQtHelperData &data, const HitTestResult &hitTestResult)
+{
+    if (hitTestResult.dontOverrideCursor || hitTestResult.windowFixedSize) {
+        return;
+    }
+    const Qt::CursorShape cs = hitTestResult.cursorShape;
+    if (cs == Qt::ArrowCursor) {
+        if (data.cursorShapeChanged) {
+            data.params->unsetCursor();
+            data.cursorShapeChanged = false;
+        }
+    } else {
+        data.params->setCursor(cs);
+        data.cursorShapeChanged = true;
+    }
+}
+
+[[nodiscard]] static inline int cursorUpdateInterval(const FramelessQtHelperData &data)
+{
+    // Once per frame is the most the user can see anyway.
+    if (const QScreen * const screen = data.params->getWindowScreen()) {
+        const qreal refreshRate = screen->refreshRate();
+        if (refreshRate > qreal(1)) {
+            return qMax(1, qRound(qreal(1000) / refreshRate));
+        }
+    }
+    return kDefaultCursorUpdateInterval;
+}
+
+static inline void flushCursorUpdate(FramelessQtHelperData &data)
+{
+    // Nothing moved during the last interval, the next move is handled right away again.
+    if (!data.cursorUpdatePending || !data.params) {
+        return;
+    }
+    data.cursorUpdatePending = false;
+    updateCursorShape(data, data.params->hitTest(data.pendingCursorPos, false));
+    data.cursorUpdateTimer->start(cursorUpdateInterval(data));
+}
+
+static inline void scheduleCursorUpdate(FramelessQtHelperData &data, const QPoint &pos)
+{
+    // The first move after a pause updates the cursor immediately, only the moves
+    // that follow within the same interval are merged into one update at its end.
+    if (!data.cursorUpdateTimer->isActive()) {
+        data.cursorUpdatePending = false;
+        updateCursorShape(data, data.params->hitTest(pos, false));
+        data.cursorUpdateTimer->start(cursorUpdateInterval(data));
+        return;
+    }
+    data.pendingCursorPos = pos;
+    if (data.cursorUpdatePending) {
+        g_coalescedMouseMoveCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    data.cursorUpdatePending = true;
+}
+
 FramelessHelperQt::FramelessHelperQt(QObject *parent) : QObject(parent) {}
 
 FramelessHelperQt::~FramelessHelperQt() = default;
 
-void FramelessHelperQt::addWindow(FramelessParamsConst params)
+void FramelessHelperQt::addWindow(const FramelessParamsShared &params)
 {
     Q_ASSERT(params);
     if (!params) {
@@ -73,15 +177,23 @@ void FramelessHelperQt::addWindow(FramelessParamsConst params)
     }
     const WId windowId = params->getWindowId();
     const auto it = g_framelessQtHelperData()->constFind(windowId);
-    if (it != g_framelessQtHelperData()->constEnd()) {
+    if ((it != g_framelessQtHelperData()->constEnd()) && it.value()) {
         return;
     }
-    FramelessQtHelperData data = {};
-    data.params = *params;
     QWindow *window = params->getWindowHandle();
     // Give it a parent so that it can be automatically deleted by Qt.
-    data.eventFilter = new FramelessHelperQt(window);
-    g_framelessQtHelperData()->insert(windowId, data);
+    const auto eventFilter = new FramelessQtWindowFilter(window, params);
+    g_framelessQtHelperData()->insert(windowId, eventFilter);
+    // Don't keep a dangling entry around if the window is destroyed without being removed.
+    connect(window, &QObject::destroyed, eventFilter, [windowId, eventFilter](){
+        if (g_framelessQtHelperData.isDestroyed()) {
+            return;
+        }
+        const auto it = g_framelessQtHelperData()->find(windowId);
+        if ((it != g_framelessQtHelperData()->end()) && (it.value() == eventFilter)) {
+            g_framelessQtHelperData()->erase(it);
+        }
+    });
     const auto shouldApplyFramelessFlag = []() -> bool {
 #ifdef Q_OS_MACOS
         return false;
@@ -103,21 +215,35 @@ void FramelessHelperQt::addWindow(FramelessParamsConst params)
         Utils::setSystemTitleBarVisible(windowId, false);
 #endif // Q_OS_LINUX
     }
-    window->installEventFilter(data.eventFilter);
+    window->installEventFilter(eventFilter);
     FramelessHelperEnableThemeAware();
 }
 
+quint64 FramelessHelperQt::coalescedMouseMoveCount()
+{
+    return g_coalescedMouseMoveCount.load(std::memory_order_relaxed);
+}
+
 void FramelessHelperQt::removeWindow(const WId windowId)
 {
     Q_ASSERT(windowId);
     if (!windowId) {
         return;
     }
-    const auto it = g_framelessQtHelperData()->constFind(windowId);
-    if (it == g_framelessQtHelperData()->constEnd()) {
+    const auto it = g_framelessQtHelperData()->find(windowId);
+    if (it == g_framelessQtHelperData()->end()) {
         return;
     }
+    const QPointer<FramelessQtWindowFilter> eventFilter = it.value();
     g_framelessQtHelperData()->erase(it);
+    // The window may still be alive, it's not ours anymore.
+    if (eventFilter) {
+        if (QObject * const window = eventFilter->parent()) {
+            window->removeEventFilter(eventFilter);
+        }
+        eventFilter->release();
+        eventFilter->deleteLater();
+    }
 #ifdef Q_OS_MACOS
     Utils::removeWindowProxy(windowId);
 #endif
@@ -140,12 +266,24 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
                 managerPriv->notifySystemThemeHasChangedOrNot();
             }
         }
-        return QObject::eventFilter(object, event);
     }
 #endif // (QT_VERSION < QT_VERSION_CHECK(6, 5, 0))
+    return QObject::eventFilter(object, event);
+}
+
+bool FramelessQtWindowFilter::eventFilter(QObject *object, QEvent *event)
+{
+    // The theme change events are handled by the base class.
+    if (FramelessHelperQt::eventFilter(object, event)) {
+        return true;
+    }
+    // Released already, see removeWindow().
+    if (!object || !event || !m_data.params) {
+        return false;
+    }
     // We are only interested in events that are dispatched to top level windows.
     if (!object->isWindowType()) {
-        return QObject::eventFilter(object, event);
+        return false;
     }
     const QEvent::Type type = event->type();
     // We are only interested in some specific mouse events (plus DPR change event).
@@ -157,24 +295,19 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
             && (type != QEvent::ScreenChangeInternal) // Qt's internal event to notify screen change and DPR change.
 #endif // (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
             ) {
-        return QObject::eventFilter(object, event);
+        return false;
     }
     const auto window = qobject_cast<QWindow *>(object);
-    const WId windowId = window->winId();
-    const auto it = g_framelessQtHelperData()->find(windowId);
-    if (it == g_framelessQtHelperData()->end()) {
-        return QObject::eventFilter(object, event);
-    }
-    const FramelessQtHelperData &data = it.value();
-    FramelessQtHelperData &muData = it.value();
+    const FramelessQtHelperData &data = m_data;
+    FramelessQtHelperData &muData = m_data;
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
     if (type == QEvent::DevicePixelRatioChange)
 #else // QT_VERSION < QT_VERSION_CHECK(6, 6, 0)
     if (type == QEvent::ScreenChangeInternal)
 #endif // (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
     {
-        data.params.forceChildrenRepaint(500);
-        return QObject::eventFilter(object, event);
+        data.params->forceChildrenRepaint(500);
+        return false;
     }
     const auto mouseEvent = static_cast<QMouseEvent *>(event);
     const Qt::MouseButton button = mouseEvent->button();
@@ -185,17 +318,25 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
     const QPoint scenePos = mouseEvent->windowPos().toPoint();
     const QPoint globalPos = mouseEvent->screenPos().toPoint();
 #endif
-    const bool windowFixedSize = data.params.isWindowFixedSize();
-    const bool ignoreThisEvent = data.params.shouldIgnoreMouseEvents(scenePos);
-    const bool insideTitleBar = data.params.isInsideTitleBarDraggableArea(scenePos);
-    const bool dontOverrideCursor = data.params.getProperty(kDontOverrideCursorVar, false).toBool();
-    const bool dontToggleMaximize = data.params.getProperty(kDontToggleMaximizeVar, false).toBool();
+    if ((type == QEvent::MouseMove) && !data.leftButtonPressed
+        && FramelessConfig::instance()->isSet(Option::EnableMouseMoveCoalescing)) {
+        // Nothing but the cursor shape depends on a mouse move without a pressed button,
+        // update it on the next tick instead of doing a hit test for every single move.
+        scheduleCursorUpdate(muData, scenePos);
+        return false;
+    }
+    // The system buttons handle their own mouse events, don't look them up.
+    const HitTestResult hitTestResult = data.params->hitTest(scenePos, false);
+    const bool windowFixedSize = hitTestResult.windowFixedSize;
+    const bool ignoreThisEvent = hitTestResult.shouldIgnoreMouseEvents;
+    const bool insideTitleBar = hitTestResult.insideTitleBarDraggableArea;
+    const bool dontToggleMaximize = hitTestResult.dontToggleMaximize;
     switch (type) {
     case QEvent::MouseButtonPress: {
         if (button == Qt::LeftButton) {
             muData.leftButtonPressed = true;
             if (!windowFixedSize) {
-                const Qt::Edges edges = Utils::calculateWindowEdges(window, scenePos);
+                const Qt::Edges edges = hitTestResult.windowEdges;
                 if (edges != Qt::Edges{}) {
                     std::ignore = Utils::startSystemResize(window, edges, globalPos);
                     event->accept();
@@ -210,7 +351,7 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
         }
         if (button == Qt::RightButton) {
             if (!ignoreThisEvent && insideTitleBar) {
-                data.params.showSystemMenu(globalPos);
+                data.params->showSystemMenu(globalPos);
                 event->accept();
                 return true;
             }
@@ -219,27 +360,18 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
     case QEvent::MouseButtonDblClick: {
         if (!dontToggleMaximize && (button == Qt::LeftButton) && !windowFixedSize && !ignoreThisEvent && insideTitleBar) {
             Qt::WindowState newWindowState = Qt::WindowNoState;
-            if (data.params.getWindowState() != Qt::WindowMaximized) {
+            if (data.params->getWindowState() != Qt::WindowMaximized) {
                 newWindowState = Qt::WindowMaximized;
             }
-            data.params.setWindowState(newWindowState);
+            data.params->setWindowState(newWindowState);
             event->accept();
             return true;
         }
     } break;
     case QEvent::MouseMove: {
-        if (!dontOverrideCursor && !windowFixedSize) {
-            const Qt::CursorShape cs = Utils::calculateCursorShape(window, scenePos);
-            if (cs == Qt::ArrowCursor) {
-                if (data.cursorShapeChanged) {
-                    data.params.unsetCursor();
-                    muData.cursorShapeChanged = false;
-                }
-            } else {
-                data.params.setCursor(cs);
-                muData.cursorShapeChanged = true;
-            }
-        }
+        // A pending cursor update is obsolete now.
+        muData.cursorUpdatePending = false;
+        updateCursorShape(muData, hitTestResult);
         if (data.leftButtonPressed) {
             if (!ignoreThisEvent && insideTitleBar) {
                 std::ignore = Utils::startSystemMove(window, globalPos);
@@ -251,7 +383,7 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
     default:
         break;
     }
-    return QObject::eventFilter(object, event);
+    return false;
 }
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -102,7 +102,7 @@ enum class WindowPart : quint8
 
 struct FramelessWin32HelperData
 {
-    SystemParameters params = {};
+    FramelessParamsShared params = nullptr;
     // Store the last hit test result, it's helpful to handle WM_MOUSEMOVE and WM_NCMOUSELEAVE.
     WindowPart lastHitTestResult = WindowPart::Outside;
     // True if we blocked a WM_MOUSELEAVE when mouse moves on chrome button, false when a
@@ -212,7 +212,7 @@ FramelessHelperWin::FramelessHelperWin() : QAbstractNativeEventFilter() {}
 
 FramelessHelperWin::~FramelessHelperWin() = default;
 
-void FramelessHelperWin::addWindow(FramelessParamsConst params)
+void FramelessHelperWin::addWindow(const FramelessParamsShared &params)
 {
     Q_ASSERT(params);
     if (!params) {
@@ -224,7 +224,7 @@ void FramelessHelperWin::addWindow(FramelessParamsConst params)
         return;
     }
     FramelessWin32HelperData data = {};
-    data.params = *params;
+    data.params = params;
     data.dpi = {Utils::getWindowDpi(windowId, true), Utils::getWindowDpi(windowId, false)};
     g_framelessWin32HelperData()->data.insert(windowId, data);
     if (!g_framelessWin32HelperData()->nativeEventFilter) {
@@ -344,7 +344,7 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
     }
     const FramelessWin32HelperData &data = it.value();
     FramelessWin32HelperData &muData = it.value();
-    const QWindow *window = data.params.getWindowHandle();
+    const QWindow *window = data.params->getWindowHandle();
     const bool frameBorderVisible = Utils::isWindowFrameBorderVisible();
     const WPARAM wParam = msg->wParam;
     const LPARAM lParam = msg->lParam;
@@ -465,7 +465,7 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
             // So we filter out these superfluous mouse leave events here to avoid this issue.
             const QPoint qtScenePos = Utils::fromNativeLocalPosition(window, QPoint{ msg->pt.x, msg->pt.y });
             SystemButtonType dummy = SystemButtonType::Unknown;
-            if (data.params.isInsideSystemButtons(qtScenePos, &dummy)) {
+            if (data.params->isInsideSystemButtons(qtScenePos, &dummy)) {
                 muData.mouseLeaveBlocked = true;
                 *result = FALSE;
                 return true;
@@ -830,7 +830,7 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
 
         const QPoint qtScenePos = Utils::fromNativeLocalPosition(window, QPoint(nativeLocalPos.x, nativeLocalPos.y));
         SystemButtonType sysButtonType = SystemButtonType::Unknown;
-        if (data.params.isInsideSystemButtons(qtScenePos, &sysButtonType)) {
+        if (data.params->isInsideSystemButtons(qtScenePos, &sysButtonType)) {
             // Even if the mouse is inside the chrome button area now, we should still allow the user
             // to be able to resize the window with the top or right window border, this is also the
             // normal behavior of a native Win32 window.
@@ -879,10 +879,10 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
         const bool full = Utils::isFullScreen(windowId);
         const int frameSizeY = Utils::getResizeBorderThickness(windowId, false, true);
         const bool isTop = (nativeLocalPos.y < frameSizeY);
-        const bool isTitleBar = data.params.isInsideTitleBarDraggableArea(qtScenePos);
-        const bool isFixedSize = data.params.isWindowFixedSize();
-        const bool dontOverrideCursor = data.params.getProperty(kDontOverrideCursorVar, false).toBool();
-        const bool dontToggleMaximize = data.params.getProperty(kDontToggleMaximizeVar, false).toBool();
+        const bool isTitleBar = data.params->isInsideTitleBarDraggableArea(qtScenePos);
+        const bool isFixedSize = data.params->isWindowFixedSize();
+        const bool dontOverrideCursor = data.params->getProperty(kDontOverrideCursorVar, false).toBool();
+        const bool dontToggleMaximize = data.params->getProperty(kDontToggleMaximizeVar, false).toBool();
 
         if (dontToggleMaximize) {
             static bool once = false;
@@ -1020,7 +1020,7 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
         const WindowPart currentWindowPart = data.lastHitTestResult;
         if (uMsg == WM_NCMOUSEMOVE) {
             if (currentWindowPart != WindowPart::ChromeButton) {
-                std::ignore = data.params.resetQtGrabbedControl();
+                std::ignore = data.params->resetQtGrabbedControl();
                 if (muData.mouseLeaveBlocked) {
                     emulateClientAreaMessage(WM_NCMOUSELEAVE);
                 }
@@ -1069,7 +1069,7 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
                 // the mouse leaves window from client area and enters window from non-client area,
                 // but it has no bad effect.
 
-                std::ignore = data.params.resetQtGrabbedControl();
+                std::ignore = data.params->resetQtGrabbedControl();
             }
         }
     } break;
@@ -1140,7 +1140,7 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
             muData.restoreGeometry.setSize(Utils::rescaleSize(data.restoreGeometry.size(), oldDpi.x, newDpi.x));
         }
 #endif // (QT_VERSION < QT_VERSION_CHECK(6, 5, 1))
-        data.params.forceChildrenRepaint(500);
+        data.params->forceChildrenRepaint(500);
     } break;
     case WM_DWMCOMPOSITIONCHANGED:
         // Re-apply the custom window frame if recovered from the basic theme.
@@ -1284,7 +1284,7 @@ bool FramelessHelperWin::nativeEventFilter(const QByteArray &eventType, void *me
                 if (WindowsVersionHelper::isWin10RS5OrGreater()) {
                     const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
                     const auto isWidget = [&data]() -> bool {
-                        const auto widget = data.params.getWidgetHandle();
+                        const auto widget = data.params->getWidgetHandle();
                         return (widget && widget->isWidgetType());
                     }();
                     if (!isWidget) {
@@ -134,6 +134,7 @@ void FramelessHelperCoreInitialize()
     // Fedora and Arch users report segfault when calling XInitThreads() and gtk_init().
     //XInitThreads(); // Users report that GTK is crashing without this.
     //gtk_init(nullptr, nullptr); // Users report that GTK functionalities won't work without this.
+    FramelessHelperPreloadSystemLibraries();
 #endif
 
 #if (defined(Q_OS_MACOS) && (QT_VERSION < QT_VERSION_CHECK(6, 0, 0)))
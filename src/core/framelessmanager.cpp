@@ -33,6 +33,7 @@
 #  include "winverhelper_p.h"
 #endif
 #include <QtCore/qvariant.h>
+#include <QtCore/qset.h>
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qfontdatabase.h>
@@ -59,7 +60,9 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
-using FramelessManagerData = QList<WId>;
+// Constant time membership tests, it may contain thousands of windows.
+// Only addWindow() and removeWindow() use it, nothing on a per event path.
+using FramelessManagerData = QSet<WId>;
 
 Q_GLOBAL_STATIC(FramelessManagerData, g_framelessManagerData)
 
@@ -342,7 +345,7 @@ void FramelessManager::setOverrideTheme(const SystemTheme theme)
     Q_EMIT systemThemeChanged();
 }
 
-void FramelessManager::addWindow(FramelessParamsConst params)
+void FramelessManager::addWindow(const FramelessParamsShared &params)
 {
     Q_ASSERT(params);
     if (!params) {
@@ -352,7 +355,7 @@ void FramelessManager::addWindow(FramelessParamsConst params)
     if (g_framelessManagerData()->contains(windowId)) {
         return;
     }
-    g_framelessManagerData()->append(windowId);
+    g_framelessManagerData()->insert(windowId);
     static const bool pureQt = usePureQtImplementation();
     if (pureQt) {
         FramelessHelperQt::addWindow(params);
@@ -372,10 +375,9 @@ void FramelessManager::removeWindow(const WId windowId)
     if (!windowId) {
         return;
     }
-    if (!g_framelessManagerData()->contains(windowId)) {
+    if (!g_framelessManagerData()->remove(windowId)) {
         return;
     }
-    g_framelessManagerData()->removeAll(windowId);
     static const bool pureQt = usePureQtImplementation();
     if (pureQt) {
         FramelessHelperQt::removeWindow(windowId);
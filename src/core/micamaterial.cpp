@@ -31,19 +31,41 @@
 #include "utils.h"
 #include "framelessconfig_p.h"
 #include "framelesshelpercore_global_p.h"
+#include "scopeguard_p.h"
+#include "atomicsharedptr_p.h"
 #include <optional>
 #include <memory>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <cstring>
 #include <QtCore/qsysinfo.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qthread.h>
-#include <QtGui/qpixmap.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qsharedmemory.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qcache.h>
 #include <QtGui/qimage.h>
 #include <QtGui/qimagereader.h>
 #include <QtGui/qpainter.h>
 #include <QtGui/qscreen.h>
 #include <QtGui/qguiapplication.h>
 #if FRAMELESSHELPER_CONFIG(private_qt)
+#  include <QtCore/private/qsimd_p.h>
 #  include <QtGui/private/qmemrotate_p.h>
 #endif
 
@@ -75,21 +97,196 @@ using namespace Global;
 [[maybe_unused]] static constexpr const qreal kDefaultTintOpacity = 0.7;
 [[maybe_unused]] static constexpr const qreal kDefaultNoiseOpacity = 0.04;
 [[maybe_unused]] static constexpr const qreal kDefaultBlurRadius = 128.0;
+// The preview is blurred at this fraction of the screen size, it takes almost no time.
+// Only needed if the real surface is larger than that.
+[[maybe_unused]] static constexpr const int kPreviewScaleFactor = 8;
+
+[[maybe_unused]] static constexpr const quint32 kWallpaperCacheMagic = 0x4D434846; // "FHCM"
+// Bump this whenever the generated image changes for the same input, eg, a new blur algorithm.
+[[maybe_unused]] static constexpr const quint32 kWallpaperCacheVersion = 2;
+[[maybe_unused]] static constexpr const char kWallpaperCacheFilePrefix[] = "micamaterial-";
+[[maybe_unused]] static constexpr const char kWallpaperCacheFileSuffix[] = ".cache";
+
+[[maybe_unused]] static constexpr const QSize kMaterialTextureSize = { 64, 64 };
+// Enough for every theme and parameter set a normal application uses, while
+// animating the tint color can't grow the cache without limit.
+[[maybe_unused]] static constexpr const int kMaterialBrushCacheSize = 64;
+// Opacities are rounded to 1/32767 in the cache key, which is far below what 8-bit color can show.
+[[maybe_unused]] static constexpr const int kMaterialOpacityPrecision = 0x7FFF;
 
 [[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultSystemLightColor2 = {243, 243, 243}; // #F3F3F3
 
 [[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultFallbackColorDark = {44, 44, 44}; // #2C2C2C
 [[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultFallbackColorLight = {249, 249, 249}; // #F9F9F9
 
+struct WallpaperScreen
+{
+    QString name = {};
+    QRect geometry = {};
+    qreal devicePixelRatio = qreal(1);
+    MicaQuality quality = MicaQuality::Balanced;
+    // Set once a newer request for the same screen supersedes this one.
+    std::shared_ptr<std::atomic<bool>> cancelled = nullptr;
+};
+
+struct WallpaperSurface
+{
+    // The screen state this surface has been (or is being) generated for.
+    WallpaperScreen screen = {};
+    // The blurred wallpaper is much smaller than the screen, it's scaled
+    // up when painting. This is the logical size it covers.
+    QSize size = {};
+    // Not a QPixmap, the image may live in memory shared with other processes
+    // (or a memory mapped file) and we don't want a private copy of it.
+    QImage image = {};
+};
+
+using WallpaperSurfaces = QHash<QString, WallpaperSurface>;
+using WallpaperSurfacesPointer = std::shared_ptr<const WallpaperSurfaces>;
+
 struct ImageData
 {
-    QPixmap blurredWallpaper = {};
-    bool graphicsResourcesReady = false;
+    // One blurred wallpaper per screen and quality, see wallpaperSurfaceKey().
+    // Only the screens that actually host a Mica material get one.
+    // It's an immutable snapshot: painting only loads the pointer and never
+    // takes the mutex, writers swap in a modified copy while holding it.
+    AtomicSharedPtr<const WallpaperSurfaces> surfaces{ std::make_shared<const WallpaperSurfaces>() };
+    QList<WallpaperScreen> pendingScreens = {};
+    bool generating = false;
     QMutex mutex{};
+    // Set while the wallpaper thread is blurring, painting used to wait for it.
+    std::atomic<bool> blurring = false;
+    std::atomic<quint64> contendedPaintCount = 0;
 };
 
 Q_GLOBAL_STATIC(ImageData, g_imageData)
 
+struct MaterialBrushData
+{
+    // Textures shared by all materials with the same theme and parameters, see materialBrushKey().
+    QCache<quint64, QBrush> brushes{ kMaterialBrushCacheSize };
+    QMutex mutex{};
+};
+
+Q_GLOBAL_STATIC(MaterialBrushData, g_materialBrushData)
+
+[[nodiscard]] static inline int quantizedMaterialOpacity(const qreal opacity)
+{
+    return qRound(qBound(qreal(0), opacity, qreal(1)) * kMaterialOpacityPrecision);
+}
+
+[[nodiscard]] static inline QBrush generateMaterialBrush(const bool dark, const QColor &tintColor, const qreal tintOpacity, const qreal noiseOpacity)
+{
+#if FRAMELESSHELPER_CONFIG(bundle_resource)
+    framelesshelpercore_initResource();
+    static const QImage noiseTexture = QImage(FRAMELESSHELPER_STRING_LITERAL(":/org.wangwenx190.FramelessHelper/resources/images/noise.png"));
+#endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
+    QImage micaTexture = QImage(kMaterialTextureSize, kDefaultImageFormat);
+    QColor fillColor = (dark ? kDefaultSystemDarkColor : kDefaultSystemLightColor2);
+    fillColor.setAlphaF(0.9f);
+    micaTexture.fill(fillColor);
+    QPainter painter(&micaTexture);
+    // We need speed, not quality.
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setRenderHint(QPainter::TextAntialiasing, false);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter.setOpacity(tintOpacity);
+    const QRect rect = {QPoint(0, 0), micaTexture.size()};
+    painter.fillRect(rect, tintColor);
+    painter.setOpacity(noiseOpacity);
+#if FRAMELESSHELPER_CONFIG(bundle_resource)
+    painter.fillRect(rect, QBrush(noiseTexture));
+#endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
+    painter.end();
+    return QBrush(micaTexture);
+}
+
+[[nodiscard]] static inline WallpaperSurfacesPointer loadWallpaperSurfaces()
+{
+    return g_imageData()->surfaces.load();
+}
+
+// The caller must hold the mutex, otherwise concurrent writers may lose each other's changes.
+template<typename Function>
+static inline void updateWallpaperSurfaces(const Function &function)
+{
+    auto surfaces = std::make_shared<WallpaperSurfaces>(*loadWallpaperSurfaces());
+    function(*surfaces);
+    g_imageData()->surfaces.store(std::move(surfaces));
+}
+
+struct BlurThreadData
+{
+    BlurThreadData()
+    {
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 2, 0))
+        // Same as the wallpaper thread, the blur shouldn't compete with the GUI thread.
+        threadPool.setThreadPriority(QThread::LowPriority);
+#endif
+    }
+
+    QThreadPool threadPool{};
+    // Zero or less means one thread per available CPU core.
+    std::atomic<int> threadCount = 0;
+};
+
+Q_GLOBAL_STATIC(BlurThreadData, g_blurThreadData)
+
+[[nodiscard]] static inline bool isSameWallpaperScreen(const WallpaperScreen &lhs, const WallpaperScreen &rhs)
+{
+    return ((lhs.name == rhs.name) && (lhs.geometry == rhs.geometry)
+        && qFuzzyCompare(lhs.devicePixelRatio, rhs.devicePixelRatio) && (lhs.quality == rhs.quality));
+}
+
+[[nodiscard]] static inline QString wallpaperSurfaceKey(const QString &screenName, const MicaQuality quality)
+{
+    return (screenName + u'/' + QString::number(int(quality)));
+}
+
+[[nodiscard]] static inline WallpaperScreen wallpaperScreen(const QScreen *screen, const MicaQuality quality)
+{
+    Q_ASSERT(screen);
+    if (!screen) {
+        return {};
+    }
+    return { screen->name(), screen->geometry(), screen->devicePixelRatio(), quality, nullptr };
+}
+
+// Same as what the 2x2 box filter mip chain produces, the odd pixels are dropped on each level.
+[[nodiscard]] static inline QSize downsampledSize(const QSize &size, const int scaleFactor)
+{
+    QSize result = size;
+    for (int factor = 1; (factor < scaleFactor) && (result.width() >= 2) && (result.height() >= 2); factor *= 2) {
+        result = QSize{ (result.width() / 2), (result.height() / 2) };
+    }
+    return result;
+}
+
+[[nodiscard]] static inline int micaQualityScaleFactor(const MicaQuality quality)
+{
+    switch (quality) {
+    case MicaQuality::Fast:
+        return 16;
+    case MicaQuality::Balanced:
+        return 8;
+    case MicaQuality::High:
+        return 4;
+    }
+    QT_WARNING_PUSH
+    QT_WARNING_DISABLE_MSVC(4702)
+    Q_UNREACHABLE_RETURN(8);
+    QT_WARNING_POP
+}
+
+[[nodiscard]] static inline int effectiveBlurThreadCount()
+{
+    const int count = g_blurThreadData()->threadCount.load(std::memory_order_relaxed);
+    if (count > 0) {
+        return count;
+    }
+    return std::max(QThread::idealThreadCount(), 1);
+}
+
 #if FRAMELESSHELPER_CONFIG(private_qt)
 template<const int shift>
 [[nodiscard]] static inline constexpr int qt_static_shift(const int value)
@@ -144,22 +341,49 @@ static inline void qt_blurinner_alphaOnly(uchar *bptr, int &z, const int alpha)
     *(bptr) = (z >> (zprec + aprec));
 }
 
+/*
+    The pixel buffer of an image as seen by the blur passes. It's taken once on
+    the calling thread: QImage::bits() and QImage::scanLine() may detach the
+    image, which must never happen concurrently from the blur thread pool.
+*/
+struct BlurBuffer
+{
+    uchar *bits = nullptr;
+    qsizetype bytesPerLine = 0;
+    int width = 0;
+    int height = 0;
+    int pixelSize = 0;
+    int alphaOffset = 0;
+};
+
+[[nodiscard]] static inline BlurBuffer qt_blurbuffer(QImage &im)
+{
+    BlurBuffer buffer = {};
+    buffer.bits = im.bits();
+    buffer.bytesPerLine = im.bytesPerLine();
+    buffer.width = im.width();
+    buffer.height = im.height();
+    buffer.pixelSize = (im.depth() >> 3);
+    buffer.alphaOffset = ((im.format() == QImage::Format_Indexed8) ? 0 : alphaIndex);
+    return buffer;
+}
+
 template<const int aprec, const int zprec, const bool alphaOnly>
-static inline void qt_blurrow(QImage &im, const int line, const int alpha)
+static inline void qt_blurrow(const BlurBuffer &buffer, const int line, const int alpha)
 {
-    uchar *bptr = im.scanLine(line);
+    uchar *bptr = (buffer.bits + (line * buffer.bytesPerLine));
 
     int zR = 0, zG = 0, zB = 0, zA = 0;
 
     QT_WARNING_PUSH
     QT_WARNING_DISABLE_MSVC(4127) // false alarm.
-    if (alphaOnly && (im.format() != QImage::Format_Indexed8)) {
-        bptr += alphaIndex;
+    if (alphaOnly) {
+        bptr += buffer.alphaOffset;
     }
     QT_WARNING_POP
 
-    const int stride = (im.depth() >> 3);
-    const int im_width = im.width();
+    const int stride = buffer.pixelSize;
+    const int im_width = buffer.width;
     for (int index = 0; index != im_width; ++index) {
         if (alphaOnly) {
             qt_blurinner_alphaOnly<aprec, zprec>(bptr, zA, alpha);
@@ -181,6 +405,621 @@ static inline void qt_blurrow(QImage &im, const int line, const int alpha)
     }
 }
 
+/*
+    The vertical counterpart of qt_blurrow(), it walks one column directly in
+    the image buffer. It visits the pixels in the same order as qt_blurrow()
+    would on the image rotated by qt_memrotate270(): the first sweep goes from
+    the bottom to the top, the second one comes back down.
+*/
+template<const int aprec, const int zprec, const bool alphaOnly>
+static inline void qt_blurcolumn(const BlurBuffer &buffer, const int column, const int alpha)
+{
+    const int im_height = buffer.height;
+    const qsizetype stride = buffer.bytesPerLine;
+    uchar *bptr = (buffer.bits + ((im_height - 1) * stride) + (column * buffer.pixelSize));
+
+    int zR = 0, zG = 0, zB = 0, zA = 0;
+
+    QT_WARNING_PUSH
+    QT_WARNING_DISABLE_MSVC(4127) // false alarm.
+    if (alphaOnly) {
+        bptr += buffer.alphaOffset;
+    }
+    QT_WARNING_POP
+
+    for (int index = (im_height - 1); index >= 0; --index) {
+        if (alphaOnly) {
+            qt_blurinner_alphaOnly<aprec, zprec>(bptr, zA, alpha);
+        } else {
+            qt_blurinner<aprec, zprec>(bptr, zR, zG, zB, zA, alpha);
+        }
+        if (index > 0) {
+            bptr -= stride;
+        }
+    }
+
+    for (int index = 1; index < im_height; ++index) {
+        bptr += stride;
+        if (alphaOnly) {
+            qt_blurinner_alphaOnly<aprec, zprec>(bptr, zA, alpha);
+        } else {
+            qt_blurinner<aprec, zprec>(bptr, zR, zG, zB, zA, alpha);
+        }
+    }
+}
+
+/*
+    The vectorized kernels below run the exact same fixed-point arithmetic as
+    qt_blurinner(), but for four lines at once: every 128-bit group holds one
+    ARGB32 pixel from each of four neighbouring lines, and every channel of
+    every pixel lives in its own 32-bit lane. The exponential filter is a
+    serial recurrence along a line, so keeping four independent lines in
+    flight is what hides the multiply latency. The output is bit-identical
+    to the scalar reference path.
+*/
+#if (defined(__SSE2__) || defined(__ARM_NEON__) || defined(__ARM_NEON))
+#  define FRAMELESSHELPER_BLUR_SIMD
+#endif
+
+// The backends are plain inline functions, make sure they are all inlined into the
+// dispatched entry points, otherwise the AVX2 ones can't be inlined into the generic
+// driver due to the target mismatch and every pixel would pay for a function call.
+#if (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#  define FRAMELESSHELPER_BLUR_FLATTEN __attribute__((flatten))
+#else
+#  define FRAMELESSHELPER_BLUR_FLATTEN
+#endif
+
+// The vertical pass works on tiles of 16 pixels, that's one cache line per row.
+static constexpr const int kBlurTileGroups = 4;
+static constexpr const int kBlurTileColumns = (kBlurTileGroups * 4);
+
+#ifdef __SSE2__
+struct BlurBackendSse2
+{
+    using Pixels = __m128i;
+
+    struct State
+    {
+        __m128i z[4] = {};
+        __m128i alpha = {};
+    };
+
+    [[nodiscard]] static inline State init(const int alpha)
+    {
+        State state = {};
+        for (auto &&z : state.z) {
+            z = _mm_setzero_si128();
+        }
+        state.alpha = _mm_set1_epi32(alpha);
+        return state;
+    }
+
+    [[nodiscard]] static inline Pixels load(const quint32 *src)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    }
+
+    static inline void store(quint32 *dst, const Pixels &pixels)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), pixels);
+    }
+
+    [[nodiscard]] static inline Pixels gather(quint32 *const *lines, const qsizetype index)
+    {
+        return _mm_set_epi32(int(lines[3][index]), int(lines[2][index]), int(lines[1][index]), int(lines[0][index]));
+    }
+
+    static inline void scatter(quint32 *const *lines, const qsizetype index, const Pixels &pixels)
+    {
+        lines[0][index] = quint32(_mm_cvtsi128_si32(pixels));
+        lines[1][index] = quint32(_mm_cvtsi128_si32(_mm_shuffle_epi32(pixels, _MM_SHUFFLE(1, 1, 1, 1))));
+        lines[2][index] = quint32(_mm_cvtsi128_si32(_mm_shuffle_epi32(pixels, _MM_SHUFFLE(2, 2, 2, 2))));
+        lines[3][index] = quint32(_mm_cvtsi128_si32(_mm_shuffle_epi32(pixels, _MM_SHUFFLE(3, 3, 3, 3))));
+    }
+
+    static inline void transpose(Pixels &p0, Pixels &p1, Pixels &p2, Pixels &p3)
+    {
+        const __m128i t0 = _mm_unpacklo_epi32(p0, p1);
+        const __m128i t1 = _mm_unpacklo_epi32(p2, p3);
+        const __m128i t2 = _mm_unpackhi_epi32(p0, p1);
+        const __m128i t3 = _mm_unpackhi_epi32(p2, p3);
+        p0 = _mm_unpacklo_epi64(t0, t1);
+        p1 = _mm_unpackhi_epi64(t0, t1);
+        p2 = _mm_unpacklo_epi64(t2, t3);
+        p3 = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    // SSE2 has no 32-bit low multiplication, emulate it with two 32x32->64 multiplications.
+    [[nodiscard]] static inline __m128i mullo(const __m128i a, const __m128i b)
+    {
+        const __m128i even = _mm_mul_epu32(a, b);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    template<const int aprec, const int zprec>
+    static inline void blur(State &state, Pixels &pixels)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i mask = _mm_set1_epi32(0xff);
+        const __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+        const __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+        __m128i channels[4] = {
+            _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+            _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)
+        };
+        for (int i = 0; i != 4; ++i) {
+            const __m128i value = _mm_slli_epi32(channels[i], zprec);
+            const __m128i delta = _mm_sub_epi32(value, _mm_srai_epi32(state.z[i], aprec));
+            state.z[i] = _mm_add_epi32(state.z[i], mullo(state.alpha, delta));
+            channels[i] = _mm_and_si128(_mm_srai_epi32(state.z[i], (zprec + aprec)), mask);
+        }
+        pixels = _mm_packus_epi16(_mm_packs_epi32(channels[0], channels[1]),
+                                  _mm_packs_epi32(channels[2], channels[3]));
+    }
+};
+
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+struct BlurBackendAvx2 : public BlurBackendSse2
+{
+    struct State
+    {
+        __m256i z[2] = {};
+        __m256i alpha = {};
+    };
+
+    [[nodiscard]] QT_FUNCTION_TARGET(AVX2) static inline State init(const int alpha)
+    {
+        State state = {};
+        for (auto &&z : state.z) {
+            z = _mm256_setzero_si256();
+        }
+        state.alpha = _mm256_set1_epi32(alpha);
+        return state;
+    }
+
+    template<const int aprec, const int zprec>
+    QT_FUNCTION_TARGET(AVX2) static inline void blur(State &state, Pixels &pixels)
+    {
+        const __m256i mask = _mm256_set1_epi32(0xff);
+        __m256i channels[2] = {
+            _mm256_cvtepu8_epi32(pixels),
+            _mm256_cvtepu8_epi32(_mm_srli_si128(pixels, 8))
+        };
+        for (int i = 0; i != 2; ++i) {
+            const __m256i value = _mm256_slli_epi32(channels[i], zprec);
+            const __m256i delta = _mm256_sub_epi32(value, _mm256_srai_epi32(state.z[i], aprec));
+            state.z[i] = _mm256_add_epi32(state.z[i], _mm256_mullo_epi32(state.alpha, delta));
+            channels[i] = _mm256_and_si256(_mm256_srai_epi32(state.z[i], (zprec + aprec)), mask);
+        }
+        // packs works per 128-bit lane, the 64-bit permute restores the pixel order.
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(channels[0], channels[1]), _MM_SHUFFLE(3, 1, 2, 0));
+        pixels = _mm_packus_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1));
+    }
+};
+#  endif // QT_COMPILER_SUPPORTS_HERE(AVX2)
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+struct BlurBackendNeon
+{
+    using Pixels = uint32x4_t;
+
+    struct State
+    {
+        int32x4_t z[4] = {};
+        int32x4_t alpha = {};
+    };
+
+    [[nodiscard]] static inline State init(const int alpha)
+    {
+        State state = {};
+        for (auto &&z : state.z) {
+            z = vdupq_n_s32(0);
+        }
+        state.alpha = vdupq_n_s32(alpha);
+        return state;
+    }
+
+    [[nodiscard]] static inline Pixels load(const quint32 *src)
+    {
+        return vld1q_u32(src);
+    }
+
+    static inline void store(quint32 *dst, const Pixels &pixels)
+    {
+        vst1q_u32(dst, pixels);
+    }
+
+    [[nodiscard]] static inline Pixels gather(quint32 *const *lines, const qsizetype index)
+    {
+        const quint32 values[4] = { lines[0][index], lines[1][index], lines[2][index], lines[3][index] };
+        return vld1q_u32(values);
+    }
+
+    static inline void scatter(quint32 *const *lines, const qsizetype index, const Pixels &pixels)
+    {
+        lines[0][index] = vgetq_lane_u32(pixels, 0);
+        lines[1][index] = vgetq_lane_u32(pixels, 1);
+        lines[2][index] = vgetq_lane_u32(pixels, 2);
+        lines[3][index] = vgetq_lane_u32(pixels, 3);
+    }
+
+    static inline void transpose(Pixels &p0, Pixels &p1, Pixels &p2, Pixels &p3)
+    {
+        const uint32x4x2_t t01 = vtrnq_u32(p0, p1);
+        const uint32x4x2_t t23 = vtrnq_u32(p2, p3);
+        p0 = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+        p1 = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+        p2 = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+        p3 = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+    }
+
+    template<const int aprec, const int zprec>
+    static inline void blur(State &state, Pixels &pixels)
+    {
+        const int32x4_t mask = vdupq_n_s32(0xff);
+        const uint8x16_t bytes = vreinterpretq_u8_u32(pixels);
+        const uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+        const uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+        int32x4_t channels[4] = {
+            vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo))), vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(lo))),
+            vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi))), vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(hi)))
+        };
+        for (int i = 0; i != 4; ++i) {
+            const int32x4_t value = vshlq_n_s32(channels[i], zprec);
+            const int32x4_t delta = vsubq_s32(value, vshrq_n_s32(state.z[i], aprec));
+            state.z[i] = vmlaq_s32(state.z[i], state.alpha, delta);
+            channels[i] = vandq_s32(vshrq_n_s32(state.z[i], (zprec + aprec)), mask);
+        }
+        const uint16x8_t packedLo = vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(channels[0])), vmovn_u32(vreinterpretq_u32_s32(channels[1])));
+        const uint16x8_t packedHi = vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(channels[2])), vmovn_u32(vreinterpretq_u32_s32(channels[3])));
+        pixels = vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(packedLo), vmovn_u16(packedHi)));
+    }
+};
+#endif
+
+#ifdef FRAMELESSHELPER_BLUR_SIMD
+/*
+    Horizontal pass: blurs the rows [first, last) of a 32-bit image, four rows at a time.
+    Every 4x4 block is transposed so that one vector holds the same column of
+    all four rows, which lets the recurrence walk along the rows. The rows
+    that can't fill a complete group fall back to qt_blurrow().
+*/
+template<typename Backend, const int aprec, const int zprec>
+static inline void qt_blurrows_simd(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    using Pixels = typename Backend::Pixels;
+    const int im_width = buffer.width;
+    const qsizetype bpl = buffer.bytesPerLine;
+    uchar * const bits = buffer.bits;
+    int line = first;
+    for (; (line + 4) <= last; line += 4) {
+        quint32 *lines[4] = {};
+        for (int i = 0; i != 4; ++i) {
+            lines[i] = reinterpret_cast<quint32 *>(bits + ((line + i) * bpl));
+        }
+        auto state = Backend::init(alpha);
+        int index = 0;
+        for (; (index + 4) <= im_width; index += 4) {
+            Pixels p0 = Backend::load(lines[0] + index);
+            Pixels p1 = Backend::load(lines[1] + index);
+            Pixels p2 = Backend::load(lines[2] + index);
+            Pixels p3 = Backend::load(lines[3] + index);
+            Backend::transpose(p0, p1, p2, p3);
+            Backend::template blur<aprec, zprec>(state, p0);
+            Backend::template blur<aprec, zprec>(state, p1);
+            Backend::template blur<aprec, zprec>(state, p2);
+            Backend::template blur<aprec, zprec>(state, p3);
+            Backend::transpose(p0, p1, p2, p3);
+            Backend::store(lines[0] + index, p0);
+            Backend::store(lines[1] + index, p1);
+            Backend::store(lines[2] + index, p2);
+            Backend::store(lines[3] + index, p3);
+        }
+        for (; index < im_width; ++index) {
+            Pixels pixels = Backend::gather(lines, index);
+            Backend::template blur<aprec, zprec>(state, pixels);
+            Backend::scatter(lines, index, pixels);
+        }
+        // The last pixel has already been visited, go back from the one before it.
+        index = (im_width - 2);
+        for (; index >= 3; index -= 4) {
+            Pixels p0 = Backend::load(lines[0] + index - 3);
+            Pixels p1 = Backend::load(lines[1] + index - 3);
+            Pixels p2 = Backend::load(lines[2] + index - 3);
+            Pixels p3 = Backend::load(lines[3] + index - 3);
+            Backend::transpose(p0, p1, p2, p3);
+            Backend::template blur<aprec, zprec>(state, p3);
+            Backend::template blur<aprec, zprec>(state, p2);
+            Backend::template blur<aprec, zprec>(state, p1);
+            Backend::template blur<aprec, zprec>(state, p0);
+            Backend::transpose(p0, p1, p2, p3);
+            Backend::store(lines[0] + index - 3, p0);
+            Backend::store(lines[1] + index - 3, p1);
+            Backend::store(lines[2] + index - 3, p2);
+            Backend::store(lines[3] + index - 3, p3);
+        }
+        for (; index >= 0; --index) {
+            Pixels pixels = Backend::gather(lines, index);
+            Backend::template blur<aprec, zprec>(state, pixels);
+            Backend::scatter(lines, index, pixels);
+        }
+    }
+    for (; line < last; ++line) {
+        qt_blurrow<aprec, zprec, false>(buffer, line, alpha);
+    }
+}
+
+/*
+    Vertical pass: blurs the columns [first, last) of a 32-bit image directly in
+    place, no transposed copy of the image is needed. Four neighbouring pixels
+    of a row are contiguous in memory, so they form a group without any
+    shuffling. The columns are processed in tiles of "groups" x 4 pixels which
+    walk the whole image height together: every row access then touches
+    complete cache lines, and the independent recurrences of the tile hide
+    each other's latency.
+*/
+template<typename Backend, const int aprec, const int zprec, const int groups>
+static inline void qt_blurcolumntile_simd(uchar *bits, const qsizetype bpl, const int column, const int height, const int alpha)
+{
+    using Pixels = typename Backend::Pixels;
+    using State = typename Backend::State;
+    State states[groups] = {};
+    for (auto &&state : states) {
+        state = Backend::init(alpha);
+    }
+    const auto blurLine = [bits, bpl, column, &states](const int line) {
+        const auto pixels = (reinterpret_cast<quint32 *>(bits + (line * bpl)) + column);
+        for (int group = 0; group != groups; ++group) {
+            Pixels value = Backend::load(pixels + (group * 4));
+            Backend::template blur<aprec, zprec>(states[group], value);
+            Backend::store(pixels + (group * 4), value);
+        }
+    };
+    // Same visiting order as qt_blurcolumn().
+    for (int line = (height - 1); line >= 0; --line) {
+        blurLine(line);
+    }
+    for (int line = 1; line < height; ++line) {
+        blurLine(line);
+    }
+}
+
+template<typename Backend, const int aprec, const int zprec>
+static inline void qt_blurcolumns_simd(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    const int im_height = buffer.height;
+    const qsizetype bpl = buffer.bytesPerLine;
+    uchar * const bits = buffer.bits;
+    int column = first;
+    for (; (column + kBlurTileColumns) <= last; column += kBlurTileColumns) {
+        qt_blurcolumntile_simd<Backend, aprec, zprec, kBlurTileGroups>(bits, bpl, column, im_height, alpha);
+    }
+    for (; (column + 4) <= last; column += 4) {
+        qt_blurcolumntile_simd<Backend, aprec, zprec, 1>(bits, bpl, column, im_height, alpha);
+    }
+    for (; column < last; ++column) {
+        qt_blurcolumn<aprec, zprec, false>(buffer, column, alpha);
+    }
+}
+#endif // FRAMELESSHELPER_BLUR_SIMD
+
+template<const int aprec, const int zprec>
+static inline void qt_blurrows_scalar(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    for (int line = first; line != last; ++line) {
+        qt_blurrow<aprec, zprec, false>(buffer, line, alpha);
+    }
+}
+
+template<const int aprec, const int zprec>
+static inline void qt_blurcolumns_scalar(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    for (int column = first; column != last; ++column) {
+        qt_blurcolumn<aprec, zprec, false>(buffer, column, alpha);
+    }
+}
+
+#ifdef __SSE2__
+template<const int aprec, const int zprec>
+FRAMELESSHELPER_BLUR_FLATTEN static void qt_blurrows_sse2(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    qt_blurrows_simd<BlurBackendSse2, aprec, zprec>(buffer, first, last, alpha);
+}
+template<const int aprec, const int zprec>
+FRAMELESSHELPER_BLUR_FLATTEN static void qt_blurcolumns_sse2(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    qt_blurcolumns_simd<BlurBackendSse2, aprec, zprec>(buffer, first, last, alpha);
+}
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+template<const int aprec, const int zprec>
+QT_FUNCTION_TARGET(AVX2) FRAMELESSHELPER_BLUR_FLATTEN static void qt_blurrows_avx2(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    qt_blurrows_simd<BlurBackendAvx2, aprec, zprec>(buffer, first, last, alpha);
+}
+template<const int aprec, const int zprec>
+QT_FUNCTION_TARGET(AVX2) FRAMELESSHELPER_BLUR_FLATTEN static void qt_blurcolumns_avx2(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    qt_blurcolumns_simd<BlurBackendAvx2, aprec, zprec>(buffer, first, last, alpha);
+}
+#  endif // QT_COMPILER_SUPPORTS_HERE(AVX2)
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+template<const int aprec, const int zprec>
+static void qt_blurrows_neon(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    qt_blurrows_simd<BlurBackendNeon, aprec, zprec>(buffer, first, last, alpha);
+}
+template<const int aprec, const int zprec>
+static void qt_blurcolumns_neon(const BlurBuffer &buffer, const int first, const int last, const int alpha)
+{
+    qt_blurcolumns_simd<BlurBackendNeon, aprec, zprec>(buffer, first, last, alpha);
+}
+#endif
+
+using BlurLinesFunction = void(*)(const BlurBuffer &, const int, const int, const int);
+
+struct BlurFunctions
+{
+    BlurLinesFunction rows = nullptr;
+    BlurLinesFunction columns = nullptr;
+};
+
+/*
+    Picks the fastest blur passes the current CPU supports. The decision is made
+    only once, the CPU won't change while the application is running.
+*/
+template<const int aprec, const int zprec>
+[[nodiscard]] static inline const BlurFunctions &qt_blur_functions()
+{
+    static const BlurFunctions functions = []() -> BlurFunctions {
+#ifdef __SSE2__
+#  if QT_COMPILER_SUPPORTS_HERE(AVX2)
+        if (qCpuHasFeature(AVX2)) {
+            DEBUG << "Using the AVX2 implementation of the exponential blur.";
+            return { &qt_blurrows_avx2<aprec, zprec>, &qt_blurcolumns_avx2<aprec, zprec> };
+        }
+#  endif // QT_COMPILER_SUPPORTS_HERE(AVX2)
+        DEBUG << "Using the SSE2 implementation of the exponential blur.";
+        return { &qt_blurrows_sse2<aprec, zprec>, &qt_blurcolumns_sse2<aprec, zprec> };
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON))
+        DEBUG << "Using the NEON implementation of the exponential blur.";
+        return { &qt_blurrows_neon<aprec, zprec>, &qt_blurcolumns_neon<aprec, zprec> };
+#else
+        DEBUG << "Using the scalar implementation of the exponential blur.";
+        return { &qt_blurrows_scalar<aprec, zprec>, &qt_blurcolumns_scalar<aprec, zprec> };
+#endif
+    }();
+    return functions;
+}
+
+// Returns true if the result is no longer needed. It's called by the blur thread pool
+// as well, so it must be thread-safe.
+using BlurInterruptionChecker = std::function<bool()>;
+
+[[nodiscard]] static inline bool qt_blurInterrupted(const BlurInterruptionChecker &interrupted)
+{
+    return (interrupted && interrupted());
+}
+
+// Lines are blurred in slices of this size, with an interruption check before each slice.
+// It's a multiple of the SIMD groups/tiles, so the slices don't change the result.
+[[maybe_unused]] static constexpr const int kBlurInterruptionCheckLines = 64;
+
+class BlurBandRunnable : public QRunnable
+{
+public:
+    explicit BlurBandRunnable(std::function<void()> &&function) : m_function(std::move(function)) {}
+    ~BlurBandRunnable() override = default;
+
+    void run() override
+    {
+        m_function();
+    }
+
+private:
+    std::function<void()> m_function = nullptr;
+};
+
+/*
+    Splits the lines [0, count) into bands and calls "function" for each of them.
+    The current thread takes the first band, the blur thread pool the others.
+    Band boundaries are multiples of "granularity", so every band keeps whole
+    SIMD groups/tiles. The lines never depend on each other within one pass,
+    so the result is the same no matter how many threads are used.
+*/
+template<typename Function>
+static inline void qt_blurbands(const int count, const int granularity, const Function &function)
+{
+    static constexpr const int kMinimumBandSize = 64;
+    const int bandCount = std::min(effectiveBlurThreadCount(), std::max((count / kMinimumBandSize), 1));
+    if (bandCount <= 1) {
+        function(0, count);
+        return;
+    }
+    int bandSize = ((count + bandCount - 1) / bandCount);
+    bandSize = (((bandSize + granularity - 1) / granularity) * granularity);
+    QThreadPool * const threadPool = &g_blurThreadData()->threadPool;
+    QSemaphore semaphore(0);
+    int started = 0;
+    for (int first = bandSize; first < count; first += bandSize) {
+        const int last = std::min((first + bandSize), count);
+        threadPool->start(new BlurBandRunnable([&function, &semaphore, first, last](){
+            function(first, last);
+            semaphore.release();
+        }));
+        ++started;
+    }
+    function(0, std::min(bandSize, count));
+    semaphore.acquire(started);
+}
+
+template<const int aprec, const int zprec, const bool alphaOnly>
+static inline void qt_blurrows(QImage &im, const int alpha, const bool improvedQuality,
+    const BlurInterruptionChecker &interrupted)
+{
+    const BlurBuffer buffer = qt_blurbuffer(im);
+    if constexpr (!alphaOnly) {
+        if (im.depth() == 32) {
+            const BlurLinesFunction function = qt_blur_functions<aprec, zprec>().rows;
+            qt_blurbands(buffer.height, 4, [&buffer, &interrupted, function, alpha, improvedQuality](const int first, const int last){
+                for (int begin = first; begin < last; begin += kBlurInterruptionCheckLines) {
+                    if (qt_blurInterrupted(interrupted)) {
+                        return;
+                    }
+                    const int end = std::min((begin + kBlurInterruptionCheckLines), last);
+                    for (int i = 0; i <= int(improvedQuality); ++i) {
+                        function(buffer, begin, end, alpha);
+                    }
+                }
+            });
+            return;
+        }
+    }
+    const int im_height = buffer.height;
+    for (int row = 0; row != im_height; ++row) {
+        if (((row % kBlurInterruptionCheckLines) == 0) && qt_blurInterrupted(interrupted)) {
+            return;
+        }
+        for (int i = 0; i <= int(improvedQuality); ++i) {
+            qt_blurrow<aprec, zprec, alphaOnly>(buffer, row, alpha);
+        }
+    }
+}
+
+template<const int aprec, const int zprec, const bool alphaOnly>
+static inline void qt_blurcolumns(QImage &im, const int alpha, const bool improvedQuality,
+    const BlurInterruptionChecker &interrupted)
+{
+    const BlurBuffer buffer = qt_blurbuffer(im);
+    if constexpr (!alphaOnly) {
+        if (im.depth() == 32) {
+            const BlurLinesFunction function = qt_blur_functions<aprec, zprec>().columns;
+            qt_blurbands(buffer.width, kBlurTileColumns, [&buffer, &interrupted, function, alpha, improvedQuality](const int first, const int last){
+                for (int begin = first; begin < last; begin += kBlurInterruptionCheckLines) {
+                    if (qt_blurInterrupted(interrupted)) {
+                        return;
+                    }
+                    const int end = std::min((begin + kBlurInterruptionCheckLines), last);
+                    for (int i = 0; i <= int(improvedQuality); ++i) {
+                        function(buffer, begin, end, alpha);
+                    }
+                }
+            });
+            return;
+        }
+    }
+    const int im_width = buffer.width;
+    for (int column = 0; column != im_width; ++column) {
+        if (((column % kBlurInterruptionCheckLines) == 0) && qt_blurInterrupted(interrupted)) {
+            return;
+        }
+        for (int i = 0; i <= int(improvedQuality); ++i) {
+            qt_blurcolumn<aprec, zprec, alphaOnly>(buffer, column, alpha);
+        }
+    }
+}
+
 /*
 *  expblur(QImage &img, int radius)
 *
@@ -199,7 +1038,8 @@ static inline void qt_blurrow(QImage &im, const int line, const int alpha)
 *  zR,zG,zB and zA in fp format 8.zprec
 */
 template<const int aprec, const int zprec, const bool alphaOnly>
-static inline void expblur(QImage &img, qreal radius, const bool improvedQuality = false, const int transposed = 0)
+static inline void expblur(QImage &img, qreal radius, const bool improvedQuality = false,
+    const int transposed = 0, const BlurInterruptionChecker &interrupted = {})
 {
     Q_ASSERT((img.format() == kDefaultImageFormat)
              || (img.format() == QImage::Format_RGB32)
@@ -224,11 +1064,16 @@ static inline void expblur(QImage &img, qreal radius, const bool improvedQuality
     const int alpha = ((radius <= qreal(1e-5)) ? ((1 << aprec) - 1) :
         std::round((1 << aprec) * (1 - qPow(cutOffIntensity / qreal(255), qreal(1) / radius))));
 
-    int img_height = img.height();
-    for (int row = 0; row != img_height; ++row) {
-        for (int i = 0; i <= int(improvedQuality); ++i) {
-            qt_blurrow<aprec, zprec, alphaOnly>(img, row, alpha);
-        }
+    qt_blurrows<aprec, zprec, alphaOnly>(img, alpha, improvedQuality, interrupted);
+    if (qt_blurInterrupted(interrupted)) {
+        return;
+    }
+
+    // The vertical pass can work on the image buffer directly, only the callers
+    // that want a transposed result still need the rotated copy.
+    if (transposed == 0) {
+        qt_blurcolumns<aprec, zprec, alphaOnly>(img, alpha, improvedQuality, interrupted);
+        return;
     }
 
     QImage temp(img.height(), img.width(), img.format());
@@ -260,28 +1105,9 @@ static inline void expblur(QImage &img, qreal radius, const bool improvedQuality
         }
     }
 
-    img_height = temp.height();
-    for (int row = 0; row != img_height; ++row) {
-        for (int i = 0; i <= int(improvedQuality); ++i) {
-            qt_blurrow<aprec, zprec, alphaOnly>(temp, row, alpha);
-        }
-    }
+    qt_blurrows<aprec, zprec, alphaOnly>(temp, alpha, improvedQuality, interrupted);
 
-    if (transposed == 0) {
-        if (img.depth() == 8) {
-            qt_memrotate90(reinterpret_cast<const quint8 *>(temp.bits()),
-                           temp.width(), temp.height(), temp.bytesPerLine(),
-                           reinterpret_cast<quint8 *>(img.bits()),
-                           img.bytesPerLine());
-        } else {
-            qt_memrotate90(reinterpret_cast<const quint32 *>(temp.bits()),
-                           temp.width(), temp.height(), temp.bytesPerLine(),
-                           reinterpret_cast<quint32 *>(img.bits()),
-                           img.bytesPerLine());
-        }
-    } else {
-        img = temp;
-    }
+    img = temp;
 }
 
 #define AVG(a,b)  ( ((((a)^(b)) & 0xfefefefeUL) >> 1) + ((a)&(b)) )
@@ -379,110 +1205,449 @@ static inline void expblur(QImage &img, qreal radius, const bool improvedQuality
             *q = AVG(AVG(p1[0], p1[1]), AVG(p2[0], p2[1]));
         }
     }
-
-    return dest;
+
+    return dest;
+}
+
+// Keeps halving the image until it's scaleFactor times smaller, or can't get any smaller.
+[[nodiscard]] static inline QImage qt_mipScaled(const QImage &source, const int scaleFactor, int *actualScaleFactor = nullptr)
+{
+    QImage result = source;
+    int factor = 1;
+    while ((factor < scaleFactor) && (result.width() >= 2) && (result.height() >= 2)) {
+        result = qt_halfScaled(result);
+        factor *= 2;
+    }
+    if (actualScaleFactor) {
+        *actualScaleFactor = factor;
+    }
+    return result;
+}
+
+[[maybe_unused]] static inline void qt_blurImage(QPainter *p, QImage &blurImage,
+    qreal radius, const bool quality, const bool alphaOnly, const int transposed = 0,
+    const BlurInterruptionChecker &interrupted = {})
+{
+    if ((blurImage.format() != kDefaultImageFormat)
+        && (blurImage.format() != QImage::Format_RGB32)) {
+        blurImage = blurImage.convertToFormat(kDefaultImageFormat);
+    }
+
+    qreal scale = 1.0;
+    if ((radius >= 4) && (blurImage.width() >= 2) && (blurImage.height() >= 2)) {
+        blurImage = qt_halfScaled(blurImage);
+        scale = 2.0;
+        radius *= 0.5;
+    }
+
+    if (alphaOnly) {
+        expblur<12, 10, true>(blurImage, radius, quality, transposed, interrupted);
+    } else {
+        expblur<12, 10, false>(blurImage, radius, quality, transposed, interrupted);
+    }
+
+    if (p && !qt_blurInterrupted(interrupted)) {
+        p->save();
+        // We need a blurry image anyway, we don't need high quality image processing.
+        p->setRenderHint(QPainter::Antialiasing, false);
+        p->setRenderHint(QPainter::TextAntialiasing, false);
+        p->setRenderHint(QPainter::SmoothPixmapTransform, false);
+        p->scale(scale, scale);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 2, 0))
+        const QSize imageSize = blurImage.deviceIndependentSize().toSize();
+#else
+        const QSize imageSize = QSizeF(QSizeF(blurImage.size()) / blurImage.devicePixelRatio()).toSize();
+#endif
+        p->drawImage(QRect(QPoint(0, 0), imageSize), blurImage);
+        p->restore();
+    }
+}
+
+[[maybe_unused]] static inline void qt_blurImage(QImage &blurImage,
+    const qreal radius, const bool quality, const int transposed = 0,
+    const BlurInterruptionChecker &interrupted = {})
+{
+    if ((blurImage.format() == QImage::Format_Indexed8)
+        || (blurImage.format() == QImage::Format_Grayscale8)) {
+        expblur<12, 10, true>(blurImage, radius, quality, transposed, interrupted);
+    } else {
+        expblur<12, 10, false>(blurImage, radius, quality, transposed, interrupted);
+    }
+}
+#endif
+
+/*!
+    Transforms an \a alignment of Qt::AlignLeft or Qt::AlignRight
+    without Qt::AlignAbsolute into Qt::AlignLeft or Qt::AlignRight with
+    Qt::AlignAbsolute according to the layout \a direction. The other
+    alignment flags are left untouched.
+
+    If no horizontal alignment was specified, the function returns the
+    default alignment for the given layout \a direction.
+
+    \sa QWidget::layoutDirection
+*/
+[[nodiscard]] static inline Qt::Alignment visualAlignment
+    (const Qt::LayoutDirection direction, Qt::Alignment alignment)
+{
+    if (!(alignment & Qt::AlignHorizontal_Mask)) {
+        alignment |= Qt::AlignLeft;
+    }
+    if (!(alignment & Qt::AlignAbsolute) && (alignment & (Qt::AlignLeft | Qt::AlignRight))) {
+        if (direction == Qt::RightToLeft) {
+            alignment ^= (Qt::AlignLeft | Qt::AlignRight);
+        }
+        alignment |= Qt::AlignAbsolute;
+    }
+    return alignment;
+}
+
+/*!
+    Returns a new rectangle of the specified \a size that is aligned to the given
+    \a rectangle according to the specified \a alignment and \a direction.
+ */
+[[nodiscard]] static inline QRect alignedRect(const Qt::LayoutDirection direction,
+    Qt::Alignment alignment, const QSize &size, const QRect &rectangle)
+{
+    alignment = visualAlignment(direction, alignment);
+    int x = rectangle.x();
+    int y = rectangle.y();
+    int w = size.width();
+    int h = size.height();
+    if ((alignment & Qt::AlignVCenter) == Qt::AlignVCenter) {
+        y += ((rectangle.size().height() / 2) - (h / 2));
+    } else if ((alignment & Qt::AlignBottom) == Qt::AlignBottom) {
+        y += (rectangle.size().height() - h);
+    }
+    if ((alignment & Qt::AlignRight) == Qt::AlignRight) {
+        x += (rectangle.size().width() - w);
+    } else if ((alignment & Qt::AlignHCenter) == Qt::AlignHCenter) {
+        x += ((rectangle.size().width() / 2) - (w / 2));
+    }
+    return {x, y, w, h};
+}
+
+struct WallpaperCacheHeader
+{
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 width = 0;
+    qint32 height = 0;
+    qint32 bytesPerLine = 0;
+    qint32 format = 0;
+    // Keep the pixel data 16-byte aligned in the mapped file.
+    quint32 reserved[2] = {};
+};
+static_assert(sizeof(WallpaperCacheHeader) == 32);
+
+/*
+    The blurred wallpaper only depends on the wallpaper file itself, how it's placed
+    on the desktop, the screen it's generated for, the blur radius and quality, so all of them
+    become part of the cache key. Any change of them results in a different file name,
+    a stale cache will never be picked up. The file name also starts with an identifier
+    of the screen and quality, so that each of them keeps its own most recent entry.
+ */
+[[nodiscard]] static inline QString wallpaperCacheFilePrefix(const WallpaperScreen &screen)
+{
+    const QByteArray screenId = QCryptographicHash::hash(wallpaperSurfaceKey(screen.name, screen.quality).toUtf8(),
+        QCryptographicHash::Sha1).toHex().left(8);
+    return (QString::fromLatin1(kWallpaperCacheFilePrefix) + QString::fromLatin1(screenId) + u'-');
+}
+
+[[nodiscard]] static inline QByteArray wallpaperFingerprint(const QString &wallpaperFilePath,
+    const WallpaperAspectStyle aspectStyle, const WallpaperScreen &screen)
+{
+    Q_ASSERT(!wallpaperFilePath.isEmpty());
+    if (wallpaperFilePath.isEmpty()) {
+        return {};
+    }
+    const QFileInfo fileInfo(wallpaperFilePath);
+    if (!fileInfo.exists()) {
+        return {};
+    }
+    QByteArray key = {};
+    {
+        QDataStream stream(&key, QIODevice::WriteOnly);
+        stream << kWallpaperCacheVersion << fileInfo.absoluteFilePath()
+               << fileInfo.lastModified().toMSecsSinceEpoch() << fileInfo.size()
+               << quint32(aspectStyle) << screen.geometry << screen.devicePixelRatio
+               << kDefaultBlurRadius << quint32(screen.quality);
+    }
+    return QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex();
+}
+
+[[nodiscard]] static inline QString wallpaperCacheFilePath(const QByteArray &fingerprint, const WallpaperScreen &screen)
+{
+    Q_ASSERT(!fingerprint.isEmpty());
+    if (fingerprint.isEmpty()) {
+        return {};
+    }
+    const QString cacheDirPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheDirPath.isEmpty()) {
+        return {};
+    }
+    return QDir(cacheDirPath).filePath(wallpaperCacheFilePrefix(screen)
+        + QString::fromLatin1(fingerprint) + QString::fromLatin1(kWallpaperCacheFileSuffix));
+}
+
+struct WallpaperCacheFileData
+{
+    QMutex mutex{};
+    // How many images currently reference the mapping of each cache file.
+    QHash<QString, int> mappedFiles = {};
+    // Cache files that were replaced while still being mapped, removed once unmapped.
+    QSet<QString> obsoleteFiles = {};
+};
+
+Q_GLOBAL_STATIC(WallpaperCacheFileData, g_wallpaperCacheFileData)
+
+static inline void releaseWallpaperCacheFile(QFile *file)
+{
+    Q_ASSERT(file);
+    if (!file) {
+        return;
+    }
+    const QString filePath = QFileInfo(file->fileName()).absoluteFilePath();
+    // Closing the file also unmaps it.
+    delete file;
+    if (g_wallpaperCacheFileData.isDestroyed()) {
+        return;
+    }
+    const QMutexLocker locker(&g_wallpaperCacheFileData()->mutex);
+    const auto it = g_wallpaperCacheFileData()->mappedFiles.find(filePath);
+    if ((it == g_wallpaperCacheFileData()->mappedFiles.end()) || (--it.value() > 0)) {
+        return;
+    }
+    g_wallpaperCacheFileData()->mappedFiles.erase(it);
+    if (g_wallpaperCacheFileData()->obsoleteFiles.remove(filePath)) {
+        QFile::remove(filePath);
+    }
+}
+
+/*
+    The returned image references the memory mapped cache file directly,
+    the file will be unmapped once the last copy of the image is gone.
+    The mapping is read-only, so the image is constructed as read-only too:
+    any write access makes QImage detach into its own buffer first.
+ */
+[[nodiscard]] static inline QImage loadWallpaperCache(const QString &filePath, const QSize &size)
+{
+    Q_ASSERT(!filePath.isEmpty());
+    Q_ASSERT(!size.isEmpty());
+    if (filePath.isEmpty() || size.isEmpty()) {
+        return {};
+    }
+    auto file = std::make_unique<QFile>(filePath);
+    if (!file->exists() || !file->open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    const qint64 fileSize = file->size();
+    if (fileSize < qint64(sizeof(WallpaperCacheHeader))) {
+        WARNING << "The wallpaper cache file is truncated:" << filePath;
+        return {};
+    }
+    const uchar * const data = file->map(0, fileSize);
+    if (!data) {
+        WARNING << "Failed to map the wallpaper cache file:" << file->errorString();
+        return {};
+    }
+    WallpaperCacheHeader header = {};
+    std::memcpy(&header, data, sizeof(header));
+    if ((header.magic != kWallpaperCacheMagic) || (header.version != kWallpaperCacheVersion)
+        || (header.width != size.width()) || (header.height != size.height())
+        || (header.format != qint32(kDefaultImageFormat)) || (header.bytesPerLine < (header.width * 4))
+        || (fileSize != (qint64(sizeof(header)) + (qint64(header.bytesPerLine) * header.height)))) {
+        WARNING << "The wallpaper cache file is invalid:" << filePath;
+        return {};
+    }
+    const QImage image(data + sizeof(header), header.width, header.height, header.bytesPerLine,
+        kDefaultImageFormat, [](void *info){ releaseWallpaperCacheFile(static_cast<QFile *>(info)); }, file.get());
+    if (image.isNull()) {
+        return {};
+    }
+    {
+        const QMutexLocker locker(&g_wallpaperCacheFileData()->mutex);
+        ++g_wallpaperCacheFileData()->mappedFiles[QFileInfo(filePath).absoluteFilePath()];
+    }
+    // The image owns the file (and thus the mapping) from now on.
+    std::ignore = file.release();
+    return image;
 }
 
-[[maybe_unused]] static inline void qt_blurImage(QPainter *p, QImage &blurImage,
-    qreal radius, const bool quality, const bool alphaOnly, const int transposed = 0)
+static inline void saveWallpaperCache(const QString &filePath, const WallpaperScreen &screen, const QImage &image)
 {
-    if ((blurImage.format() != kDefaultImageFormat)
-        && (blurImage.format() != QImage::Format_RGB32)) {
-        blurImage = blurImage.convertToFormat(kDefaultImageFormat);
+    Q_ASSERT(!filePath.isEmpty());
+    Q_ASSERT(!image.isNull());
+    if (filePath.isEmpty() || image.isNull() || (image.format() != kDefaultImageFormat)) {
+        return;
     }
-
-    qreal scale = 1.0;
-    if ((radius >= 4) && (blurImage.width() >= 2) && (blurImage.height() >= 2)) {
-        blurImage = qt_halfScaled(blurImage);
-        scale = 2.0;
-        radius *= 0.5;
+    const QFileInfo fileInfo(filePath);
+    QDir cacheDir = fileInfo.absoluteDir();
+    if (!cacheDir.exists() && !cacheDir.mkpath(FRAMELESSHELPER_STRING_LITERAL("."))) {
+        WARNING << "Failed to create the cache directory:" << cacheDir.absolutePath();
+        return;
     }
-
-    if (alphaOnly) {
-        expblur<12, 10, true>(blurImage, radius, quality, transposed);
-    } else {
-        expblur<12, 10, false>(blurImage, radius, quality, transposed);
+    // We only keep the most recent wallpaper of each screen, anything else can't be used anymore.
+    // Files we still have mapped are removed once the last image using them is gone, Windows
+    // refuses to delete them before that. The ones mapped by other processes stay until one
+    // of the following saves succeeds in removing them.
+    const QStringList cacheFiles = cacheDir.entryList({ wallpaperCacheFilePrefix(screen)
+        + u'*' + QString::fromLatin1(kWallpaperCacheFileSuffix) }, QDir::Files);
+    for (auto &&cacheFile : std::as_const(cacheFiles)) {
+        if (cacheFile == fileInfo.fileName()) {
+            continue;
+        }
+        const QString cacheFilePath = cacheDir.absoluteFilePath(cacheFile);
+        const QMutexLocker locker(&g_wallpaperCacheFileData()->mutex);
+        if (g_wallpaperCacheFileData()->mappedFiles.contains(cacheFilePath)) {
+            g_wallpaperCacheFileData()->obsoleteFiles.insert(cacheFilePath);
+        } else if (!QFile::remove(cacheFilePath)) {
+            DEBUG << "The stale wallpaper cache file is still in use:" << cacheFilePath;
+        }
     }
-
-    if (p) {
-        p->save();
-        // We need a blurry image anyway, we don't need high quality image processing.
-        p->setRenderHint(QPainter::Antialiasing, false);
-        p->setRenderHint(QPainter::TextAntialiasing, false);
-        p->setRenderHint(QPainter::SmoothPixmapTransform, false);
-        p->scale(scale, scale);
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 2, 0))
-        const QSize imageSize = blurImage.deviceIndependentSize().toSize();
-#else
-        const QSize imageSize = QSizeF(QSizeF(blurImage.size()) / blurImage.devicePixelRatio()).toSize();
-#endif
-        p->drawImage(QRect(QPoint(0, 0), imageSize), blurImage);
-        p->restore();
+    WallpaperCacheHeader header = {};
+    header.magic = kWallpaperCacheMagic;
+    header.version = kWallpaperCacheVersion;
+    header.width = image.width();
+    header.height = image.height();
+    header.bytesPerLine = image.bytesPerLine();
+    header.format = qint32(image.format());
+    // QSaveFile makes sure other processes never see a partially written file.
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        WARNING << "Failed to create the wallpaper cache file:" << file.errorString();
+        return;
+    }
+    const qint64 dataSize = (qint64(image.bytesPerLine()) * image.height());
+    if ((file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != qint64(sizeof(header)))
+        || (file.write(reinterpret_cast<const char *>(image.constBits()), dataSize) != dataSize)) {
+        WARNING << "Failed to write the wallpaper cache file:" << file.errorString();
+        file.cancelWriting();
+        return;
+    }
+    if (!file.commit()) {
+        WARNING << "Failed to save the wallpaper cache file:" << file.errorString();
     }
 }
 
-[[maybe_unused]] static inline void qt_blurImage(QImage &blurImage,
-    const qreal radius, const bool quality, const int transposed = 0)
+#if QT_CONFIG(sharedmemory)
+struct SharedWallpaperHeader
 {
-    if ((blurImage.format() == QImage::Format_Indexed8)
-        || (blurImage.format() == QImage::Format_Grayscale8)) {
-        expblur<12, 10, true>(blurImage, radius, quality, transposed);
-    } else {
-        expblur<12, 10, false>(blurImage, radius, quality, transposed);
-    }
-}
-#endif
+    quint32 magic = 0;
+    quint32 version = 0;
+    // Only set once the pixel data is complete, while holding the lock.
+    quint32 ready = 0;
+    qint32 width = 0;
+    qint32 height = 0;
+    qint32 bytesPerLine = 0;
+    qint32 format = 0;
+    // Hex encoded SHA-1 of the cache key, guards against segment name clashes.
+    char fingerprint[40] = {};
+    // Keep the pixel data 16-byte aligned in the segment.
+    quint32 reserved[3] = {};
+};
+static_assert(sizeof(SharedWallpaperHeader) == 80);
 
-/*!
-    Transforms an \a alignment of Qt::AlignLeft or Qt::AlignRight
-    without Qt::AlignAbsolute into Qt::AlignLeft or Qt::AlignRight with
-    Qt::AlignAbsolute according to the layout \a direction. The other
-    alignment flags are left untouched.
+[[nodiscard]] static inline std::unique_ptr<QSharedMemory> createSharedWallpaperMemory(const QByteArray &fingerprint)
+{
+    Q_ASSERT(fingerprint.size() == sizeof(SharedWallpaperHeader::fingerprint));
+    const QString key = FRAMELESSHELPER_STRING_LITERAL("org.wangwenx190.FramelessHelper.MicaMaterial.") + QString::fromLatin1(fingerprint);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
+    return std::make_unique<QSharedMemory>(QSharedMemory::legacyNativeKey(key));
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 6, 0))
+    return std::make_unique<QSharedMemory>(key);
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
+}
 
-    If no horizontal alignment was specified, the function returns the
-    default alignment for the given layout \a direction.
+[[nodiscard]] static inline QImage sharedWallpaperImage(std::unique_ptr<QSharedMemory> &&sharedMemory, const SharedWallpaperHeader &header)
+{
+    const auto data = (static_cast<const uchar *>(sharedMemory->constData()) + sizeof(header));
+    const QImage image(data, header.width, header.height, header.bytesPerLine, kDefaultImageFormat,
+        [](void *info){ delete static_cast<QSharedMemory *>(info); }, sharedMemory.get());
+    if (image.isNull()) {
+        return {};
+    }
+    // The image keeps the segment attached from now on.
+    std::ignore = sharedMemory.release();
+    return image;
+}
 
-    \sa QWidget::layoutDirection
-*/
-[[nodiscard]] static inline Qt::Alignment visualAlignment
-    (const Qt::LayoutDirection direction, Qt::Alignment alignment)
+/*
+    Maps the blurred wallpaper another process has published, read-only.
+    The segment lives as long as any process still has it attached.
+ */
+[[nodiscard]] static inline QImage attachSharedWallpaper(const QByteArray &fingerprint, const QSize &size)
 {
-    if (!(alignment & Qt::AlignHorizontal_Mask)) {
-        alignment |= Qt::AlignLeft;
+    Q_ASSERT(!fingerprint.isEmpty());
+    Q_ASSERT(!size.isEmpty());
+    if (fingerprint.isEmpty() || size.isEmpty()) {
+        return {};
     }
-    if (!(alignment & Qt::AlignAbsolute) && (alignment & (Qt::AlignLeft | Qt::AlignRight))) {
-        if (direction == Qt::RightToLeft) {
-            alignment ^= (Qt::AlignLeft | Qt::AlignRight);
-        }
-        alignment |= Qt::AlignAbsolute;
+    std::unique_ptr<QSharedMemory> sharedMemory = createSharedWallpaperMemory(fingerprint);
+    if (!sharedMemory->attach(QSharedMemory::ReadOnly)) {
+        return {};
     }
-    return alignment;
+    if (sharedMemory->size() < qsizetype(sizeof(SharedWallpaperHeader))) {
+        return {};
+    }
+    SharedWallpaperHeader header = {};
+    if (!sharedMemory->lock()) {
+        return {};
+    }
+    std::memcpy(&header, sharedMemory->constData(), sizeof(header));
+    sharedMemory->unlock();
+    // Not being ready means the producer is still working on it (or has crashed),
+    // don't wait for it, the caller has other ways to get the image.
+    if ((header.magic != kWallpaperCacheMagic) || (header.version != kWallpaperCacheVersion) || !header.ready
+        || (std::memcmp(header.fingerprint, fingerprint.constData(), sizeof(header.fingerprint)) != 0)
+        || (header.width != size.width()) || (header.height != size.height())
+        || (header.format != qint32(kDefaultImageFormat)) || (header.bytesPerLine < (header.width * 4))
+        || (sharedMemory->size() < (qsizetype(sizeof(header)) + (qsizetype(header.bytesPerLine) * header.height)))) {
+        return {};
+    }
+    return sharedWallpaperImage(std::move(sharedMemory), header);
 }
 
-/*!
-    Returns a new rectangle of the specified \a size that is aligned to the given
-    \a rectangle according to the specified \a alignment and \a direction.
+/*
+    Copies the image into a new shared memory segment for the other processes and
+    returns the copy that lives in the segment, so that this process doesn't keep a
+    second one. Returns a null image if the segment exists already or can't be created.
  */
-[[nodiscard]] static inline QRect alignedRect(const Qt::LayoutDirection direction,
-    Qt::Alignment alignment, const QSize &size, const QRect &rectangle)
+[[nodiscard]] static inline QImage publishSharedWallpaper(const QByteArray &fingerprint, const QImage &image)
 {
-    alignment = visualAlignment(direction, alignment);
-    int x = rectangle.x();
-    int y = rectangle.y();
-    int w = size.width();
-    int h = size.height();
-    if ((alignment & Qt::AlignVCenter) == Qt::AlignVCenter) {
-        y += ((rectangle.size().height() / 2) - (h / 2));
-    } else if ((alignment & Qt::AlignBottom) == Qt::AlignBottom) {
-        y += (rectangle.size().height() - h);
+    Q_ASSERT(!fingerprint.isEmpty());
+    Q_ASSERT(!image.isNull());
+    if (fingerprint.isEmpty() || image.isNull() || (image.format() != kDefaultImageFormat)) {
+        return {};
     }
-    if ((alignment & Qt::AlignRight) == Qt::AlignRight) {
-        x += (rectangle.size().width() - w);
-    } else if ((alignment & Qt::AlignHCenter) == Qt::AlignHCenter) {
-        x += ((rectangle.size().width() / 2) - (w / 2));
+    const qsizetype dataSize = (qsizetype(image.bytesPerLine()) * image.height());
+    std::unique_ptr<QSharedMemory> sharedMemory = createSharedWallpaperMemory(fingerprint);
+    if (!sharedMemory->create(qsizetype(sizeof(SharedWallpaperHeader)) + dataSize)) {
+        if (sharedMemory->error() != QSharedMemory::AlreadyExists) {
+            WARNING << "Failed to create the shared memory for the wallpaper:" << sharedMemory->errorString();
+        }
+        return {};
     }
-    return {x, y, w, h};
+    SharedWallpaperHeader header = {};
+    header.magic = kWallpaperCacheMagic;
+    header.version = kWallpaperCacheVersion;
+    header.width = image.width();
+    header.height = image.height();
+    header.bytesPerLine = image.bytesPerLine();
+    header.format = qint32(image.format());
+    std::memcpy(header.fingerprint, fingerprint.constData(), sizeof(header.fingerprint));
+    if (!sharedMemory->lock()) {
+        WARNING << "Failed to lock the shared memory for the wallpaper:" << sharedMemory->errorString();
+        return {};
+    }
+    const auto data = static_cast<uchar *>(sharedMemory->data());
+    std::memcpy((data + sizeof(header)), image.constBits(), dataSize);
+    header.ready = 1;
+    std::memcpy(data, &header, sizeof(header));
+    sharedMemory->unlock();
+    return sharedWallpaperImage(std::move(sharedMemory), header);
 }
+#endif // QT_CONFIG(sharedmemory)
 
 class WallpaperThread : public QThread
 {
@@ -499,23 +1664,119 @@ Q_SIGNALS:
 
 protected:
     void run() override
+    {
+        while (!isInterruptionRequested()) {
+            WallpaperScreen screen = {};
+            {
+                const QMutexLocker locker(&g_imageData()->mutex);
+                if (g_imageData()->pendingScreens.isEmpty()) {
+                    g_imageData()->generating = false;
+                    return;
+                }
+                screen = g_imageData()->pendingScreens.takeFirst();
+            }
+            const QImage image = generateBlurredWallpaper(screen);
+            if (image.isNull()) {
+                continue;
+            }
+            publishWallpaper(screen, image);
+        }
+        const QMutexLocker locker(&g_imageData()->mutex);
+        g_imageData()->generating = false;
+    }
+
+private:
+    [[nodiscard]] bool isStale(const WallpaperScreen &screen) const
+    {
+        return (isInterruptionRequested() || (screen.cancelled && screen.cancelled->load(std::memory_order_relaxed)));
+    }
+
+    void publishWallpaper(const WallpaperScreen &screen, const QImage &image)
+    {
+        {
+            const QString key = wallpaperSurfaceKey(screen.name, screen.quality);
+            const QMutexLocker locker(&g_imageData()->mutex);
+            const WallpaperSurfacesPointer surfaces = loadWallpaperSurfaces();
+            const auto it = surfaces->constFind(key);
+            // The screen may have been removed or requested again in the mean time.
+            if ((it == surfaces->constEnd()) || (it->screen.cancelled != screen.cancelled)) {
+                return;
+            }
+            updateWallpaperSurfaces([&key, &screen, &image](WallpaperSurfaces &surfaces){
+                WallpaperSurface &surface = surfaces[key];
+                surface.size = screen.geometry.size();
+                surface.image = image;
+            });
+        }
+        Q_EMIT imageUpdated();
+    }
+
+    [[nodiscard]] QImage generateBlurredWallpaper(const WallpaperScreen &screen)
     {
         const QString wallpaperFilePath = Utils::getWallpaperFilePath();
         if (wallpaperFilePath.isEmpty()) {
             WARNING << "Failed to retrieve the wallpaper file path.";
-            return;
+            return {};
+        }
+        const WallpaperAspectStyle aspectStyle = Utils::getWallpaperAspectStyle();
+        const QSize wallpaperSize = screen.geometry.size();
+#if FRAMELESSHELPER_CONFIG(private_qt)
+        const int scaleFactor = micaQualityScaleFactor(screen.quality);
+#else // !FRAMELESSHELPER_CONFIG(private_qt)
+        // Without the blur there's nothing to hide the details, keep the full size.
+        static constexpr const int scaleFactor = 1;
+#endif // FRAMELESSHELPER_CONFIG(private_qt)
+        const QSize blurredSize = downsampledSize(wallpaperSize, scaleFactor);
+        const QByteArray fingerprint = wallpaperFingerprint(wallpaperFilePath, aspectStyle, screen);
+#if QT_CONFIG(sharedmemory)
+        const bool shareBetweenProcesses = (!fingerprint.isEmpty()
+            && FramelessConfig::instance()->isSet(Option::EnableMicaMaterialSharedMemoryCache));
+        if (shareBetweenProcesses) {
+            // Another process may have done all the work for us already.
+            const QImage sharedImage = attachSharedWallpaper(fingerprint, blurredSize);
+            if (!sharedImage.isNull()) {
+                DEBUG << "Using the blurred wallpaper shared by another process.";
+                return sharedImage;
+            }
+        }
+        const auto share = [shareBetweenProcesses, &fingerprint](const QImage &image) -> QImage {
+            if (shareBetweenProcesses) {
+                const QImage sharedImage = publishSharedWallpaper(fingerprint, image);
+                if (!sharedImage.isNull()) {
+                    return sharedImage;
+                }
+            }
+            return image;
+        };
+#else // !QT_CONFIG(sharedmemory)
+        const auto share = [](const QImage &image) -> QImage { return image; };
+#endif // QT_CONFIG(sharedmemory)
+        const bool useDiskCache = (!fingerprint.isEmpty()
+            && FramelessConfig::instance()->isSet(Option::EnableMicaMaterialDiskCache));
+        const QString cacheFilePath = (useDiskCache ? wallpaperCacheFilePath(fingerprint, screen) : QString{});
+        if (!cacheFilePath.isEmpty()) {
+            // Decoding and blurring the wallpaper takes quite some time, reuse
+            // the result of a previous run if nothing has changed since then.
+            const QImage cachedImage = loadWallpaperCache(cacheFilePath, blurredSize);
+            if (!cachedImage.isNull()) {
+                DEBUG << "Using the cached blurred wallpaper:" << cacheFilePath;
+                return share(cachedImage);
+            }
+        }
+        if (isStale(screen)) {
+            return {};
         }
         // QImageReader allows us read the image size before we actually loading it, this behavior
         // can help us avoid consume too much memory if the image resolution is very large, eg, 4K.
         QImageReader reader(wallpaperFilePath);
         if (!reader.canRead()) {
             WARNING << "Qt can't read the wallpaper file:" << reader.errorString();
-            return;
+            return {};
         }
         const QSize actualSize = reader.size();
         if (actualSize.isEmpty()) {
             WARNING << "The wallpaper picture size is invalid.";
-            return;
+            return {};
         }
         const QSize correctedSize = (actualSize > kMaximumPictureSize ? kMaximumPictureSize : actualSize);
         if (correctedSize != actualSize) {
@@ -525,14 +1786,15 @@ protected:
         QImage image(correctedSize, kDefaultImageFormat);
         if (!reader.read(&image)) {
             WARNING << "Failed to read the wallpaper image:" << reader.errorString();
-            return;
+            return {};
         }
         if (image.isNull()) {
             WARNING << "The obtained image data is null.";
-            return;
+            return {};
+        }
+        if (isStale(screen)) {
+            return {};
         }
-        WallpaperAspectStyle aspectStyle = Utils::getWallpaperAspectStyle();
-        const QSize wallpaperSize = QGuiApplication::primaryScreen()->size();
         QImage buffer(wallpaperSize, kDefaultImageFormat);
 #ifdef Q_OS_WINDOWS
         if (aspectStyle == WallpaperAspectStyle::Center) {
@@ -570,22 +1832,45 @@ protected:
             const QRect rect = alignedRect(Qt::LeftToRight, Qt::AlignCenter, image.size(), desktopRect);
             bufferPainter.drawImage(rect.topLeft(), image);
         }
-        {
-            const QMutexLocker locker(&g_imageData()->mutex);
-            g_imageData()->blurredWallpaper = QPixmap(wallpaperSize);
-            g_imageData()->blurredWallpaper.fill(kDefaultTransparentColor);
-            QPainter painter(&g_imageData()->blurredWallpaper);
-            // Same here.
-            painter.setRenderHint(QPainter::Antialiasing, false);
-            painter.setRenderHint(QPainter::TextAntialiasing, false);
-            painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+        if (isStale(screen)) {
+            return {};
+        }
+        const BlurInterruptionChecker interrupted = [this, &screen]() -> bool { return isStale(screen); };
+        g_imageData()->blurring.store(true, std::memory_order_relaxed);
+        const auto blurringGuard = qScopeGuard([](){
+            g_imageData()->blurring.store(false, std::memory_order_relaxed);
+        });
 #if FRAMELESSHELPER_CONFIG(private_qt)
-            qt_blurImage(&painter, buffer, kDefaultBlurRadius, false, false);
+        // The output of such a large blur radius is almost featureless, blurring it at full size
+        // is a waste of time. Shrink it with a mip chain of 2x2 box filters first, blur the small
+        // image with a proportionally smaller radius and keep it small. The painter scales it up
+        // with bilinear filtering, which is indistinguishable from the full size blur.
+        int blurredScaleFactor = 1;
+        QImage blurredImage = qt_mipScaled(buffer, scaleFactor, &blurredScaleFactor);
+        buffer = {};
+        if (blurredScaleFactor < kPreviewScaleFactor) {
+            // The full blur takes a while, show a cheap low resolution version in the mean time.
+            int previewScaleFactor = 1;
+            QImage preview = qt_mipScaled(blurredImage, (kPreviewScaleFactor / blurredScaleFactor), &previewScaleFactor);
+            previewScaleFactor *= blurredScaleFactor;
+            qt_blurImage(preview, (kDefaultBlurRadius / previewScaleFactor), false, 0, interrupted);
+            if (isStale(screen)) {
+                return {};
+            }
+            publishWallpaper(screen, preview);
+        }
+        qt_blurImage(blurredImage, (kDefaultBlurRadius / blurredScaleFactor), false, 0, interrupted);
 #else // !FRAMELESSHELPER_CONFIG(private_qt)
-            painter.drawImage(desktopOriginPoint, buffer);
+        const QImage blurredImage = buffer;
 #endif // FRAMELESSHELPER_CONFIG(private_qt)
+        // Never let a partially blurred image escape.
+        if (isStale(screen)) {
+            return {};
         }
-        Q_EMIT imageUpdated();
+        if (!cacheFilePath.isEmpty()) {
+            saveWallpaperCache(cacheFilePath, screen, blurredImage);
+        }
+        return share(blurredImage);
     }
 };
 
@@ -607,6 +1892,52 @@ static inline void threadCleaner()
     }
 }
 
+static inline void requestBlurredWallpaper(const QScreen *screen, const MicaQuality quality, const bool force)
+{
+    Q_ASSERT(screen);
+    if (!screen) {
+        return;
+    }
+    WallpaperScreen request = wallpaperScreen(screen, quality);
+    const QString key = wallpaperSurfaceKey(request.name, quality);
+    g_imageData()->mutex.lock();
+    const WallpaperSurfacesPointer surfaces = loadWallpaperSurfaces();
+    const auto it = surfaces->constFind(key);
+    // Nothing to do if the surface is ready or in progress already.
+    if (!force && (it != surfaces->constEnd()) && isSameWallpaperScreen(it->screen, request)) {
+        g_imageData()->mutex.unlock();
+        return;
+    }
+    // The job of the previous request is stale now, let it stop as soon as possible instead
+    // of waiting for it. The old surface (if any) will continue to be used until the new one is ready.
+    if ((it != surfaces->constEnd()) && it->screen.cancelled) {
+        it->screen.cancelled->store(true, std::memory_order_relaxed);
+    }
+    request.cancelled = std::make_shared<std::atomic<bool>>(false);
+    updateWallpaperSurfaces([&key, &request](WallpaperSurfaces &surfaces){
+        surfaces[key].screen = request;
+    });
+    QList<WallpaperScreen> &pendingScreens = g_imageData()->pendingScreens;
+    pendingScreens.erase(std::remove_if(pendingScreens.begin(), pendingScreens.end(),
+        [&request](const WallpaperScreen &pending){
+            return ((pending.name == request.name) && (pending.quality == request.quality));
+        }),
+        pendingScreens.end());
+    pendingScreens.append(request);
+    const bool shouldStart = !g_imageData()->generating;
+    g_imageData()->generating = true;
+    g_imageData()->mutex.unlock();
+    if (!shouldStart) {
+        return;
+    }
+    const QMutexLocker locker(&g_threadData()->mutex);
+    if (g_threadData()->thread->isRunning()) {
+        // It has run out of work and is about to exit.
+        g_threadData()->thread->wait();
+    }
+    g_threadData()->thread->start(QThread::LowPriority);
+}
+
 MicaMaterialPrivate::MicaMaterialPrivate(MicaMaterial *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -637,46 +1968,27 @@ const MicaMaterialPrivate *MicaMaterialPrivate::get(const MicaMaterial *q)
     return q->d_func();
 }
 
-void MicaMaterialPrivate::maybeGenerateBlurredWallpaper(const bool force)
+void MicaMaterialPrivate::maybeGenerateBlurredWallpaper(const QScreen *screen, const bool force)
 {
-    g_imageData()->mutex.lock();
-    if (!g_imageData()->blurredWallpaper.isNull() && !force) {
-        g_imageData()->mutex.unlock();
-        return;
-    }
-    g_imageData()->mutex.unlock();
-    const QMutexLocker locker(&g_threadData()->mutex);
-    if (g_threadData()->thread->isRunning()) {
-        g_threadData()->thread->requestInterruption();
-        g_threadData()->thread->quit();
-        g_threadData()->thread->wait();
-    }
-    g_threadData()->thread->start(QThread::LowPriority);
+    requestBlurredWallpaper(screen, quality, force);
 }
 
 void MicaMaterialPrivate::updateMaterialBrush()
 {
-#if FRAMELESSHELPER_CONFIG(bundle_resource)
-    framelesshelpercore_initResource();
-    static const QImage noiseTexture = QImage(FRAMELESSHELPER_STRING_LITERAL(":/org.wangwenx190.FramelessHelper/resources/images/noise.png"));
-#endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
-    QImage micaTexture = QImage(QSize(64, 64), kDefaultImageFormat);
-    QColor fillColor = ((FramelessManager::instance()->systemTheme() == SystemTheme::Dark) ? kDefaultSystemDarkColor : kDefaultSystemLightColor2);
-    fillColor.setAlphaF(0.9f);
-    micaTexture.fill(fillColor);
-    QPainter painter(&micaTexture);
-    // Same as above. We need speed, not quality.
-    painter.setRenderHint(QPainter::Antialiasing, false);
-    painter.setRenderHint(QPainter::TextAntialiasing, false);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
-    painter.setOpacity(tintOpacity);
-    const QRect rect = {QPoint(0, 0), micaTexture.size()};
-    painter.fillRect(rect, tintColor);
-    painter.setOpacity(noiseOpacity);
-#if FRAMELESSHELPER_CONFIG(bundle_resource)
-    painter.fillRect(rect, QBrush(noiseTexture));
-#endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
-    micaBrush = QBrush(micaTexture);
+    const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
+    const int tint = quantizedMaterialOpacity(tintOpacity);
+    const int noise = quantizedMaterialOpacity(noiseOpacity);
+    const quint64 key = ((quint64(dark) << 62) | (quint64(tintColor.rgba()) << 30) | (quint64(tint) << 15) | quint64(noise));
+    {
+        const QMutexLocker locker(&g_materialBrushData()->mutex);
+        if (const QBrush * const brush = g_materialBrushData()->brushes.object(key)) {
+            // QBrush is implicitly shared, all materials with the same key use the same texture.
+            micaBrush = *brush;
+        } else {
+            micaBrush = generateMaterialBrush(dark, tintColor, (qreal(tint) / kMaterialOpacityPrecision), (qreal(noise) / kMaterialOpacityPrecision));
+            g_materialBrushData()->brushes.insert(key, new QBrush(micaBrush));
+        }
+    }
     if (initialized) {
         Q_Q(MicaMaterial);
         Q_EMIT q->shouldRedraw();
@@ -685,8 +1997,16 @@ void MicaMaterialPrivate::updateMaterialBrush()
 
 void MicaMaterialPrivate::forceRebuildWallpaper()
 {
-    wallpaperSize = QGuiApplication::primaryScreen()->size();
-    maybeGenerateBlurredWallpaper(true);
+    const WallpaperSurfacesPointer surfaces = loadWallpaperSurfaces();
+    const QList<QScreen *> screens = QGuiApplication::screens();
+    for (auto &&surface : std::as_const(*surfaces)) {
+        for (auto &&screen : std::as_const(screens)) {
+            if (screen->name() == surface.screen.name) {
+                requestBlurredWallpaper(screen, surface.screen.quality, true);
+                break;
+            }
+        }
+    }
 }
 
 void MicaMaterialPrivate::initialize()
@@ -704,8 +2024,6 @@ void MicaMaterialPrivate::initialize()
     });
     g_threadData()->mutex.unlock();
 
-    wallpaperSize = QGuiApplication::primaryScreen()->size();
-
     tintColor = kDefaultTransparentColor;
     tintOpacity = kDefaultTintOpacity;
     // Leave fallbackColor invalid, we need to use this state to judge
@@ -718,80 +2036,93 @@ void MicaMaterialPrivate::initialize()
         this, &MicaMaterialPrivate::updateMaterialBrush);
     connect(FramelessManager::instance(), &FramelessManager::wallpaperChanged,
         this, &MicaMaterialPrivate::forceRebuildWallpaper);
-    connect(qGuiApp, &QGuiApplication::primaryScreenChanged,
-        this, &MicaMaterialPrivate::forceRebuildWallpaper);
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, [](QScreen *screen){
+        const QString screenName = screen->name();
+        const QMutexLocker locker(&g_imageData()->mutex);
+        updateWallpaperSurfaces([&screenName](WallpaperSurfaces &surfaces){
+            for (auto it = surfaces.begin(); it != surfaces.end();) {
+                if (it->screen.name != screenName) {
+                    ++it;
+                    continue;
+                }
+                if (it->screen.cancelled) {
+                    it->screen.cancelled->store(true, std::memory_order_relaxed);
+                }
+                it = surfaces.erase(it);
+            }
+        });
+    });
 
     if (FramelessConfig::instance()->isSet(Option::DisableLazyInitializationForMicaMaterial)) {
-        prepareGraphicsResources();
+        // Most windows will be shown on the primary screen, warm it up.
+        maybeGenerateBlurredWallpaper(QGuiApplication::primaryScreen());
     }
 
     initialized = true;
 }
 
-void MicaMaterialPrivate::prepareGraphicsResources()
+QColor MicaMaterialPrivate::systemFallbackColor()
 {
-    g_imageData()->mutex.lock();
-    if (g_imageData()->graphicsResourcesReady) {
-        g_imageData()->mutex.unlock();
-        return;
-    }
-    g_imageData()->graphicsResourcesReady = true;
-    g_imageData()->mutex.unlock();
-    maybeGenerateBlurredWallpaper();
+    return ((FramelessManager::instance()->systemTheme() == SystemTheme::Dark) ? kDefaultFallbackColorDark : kDefaultFallbackColorLight);
 }
 
-QColor MicaMaterialPrivate::systemFallbackColor()
+QScreen *MicaMaterialPrivate::findScreen(const QRect &rect)
 {
-    return ((FramelessManager::instance()->systemTheme() == SystemTheme::Dark) ? kDefaultFallbackColorDark : kDefaultFallbackColorLight);
+    // The screen that contains the center of the rectangle is what the user sees.
+    const QPoint center = rect.center();
+    const QList<QScreen *> screens = QGuiApplication::screens();
+    for (auto &&screen : std::as_const(screens)) {
+        if (screen->geometry().contains(center)) {
+            return screen;
+        }
+    }
+    return QGuiApplication::primaryScreen();
 }
 
-QPoint MicaMaterialPrivate::mapToWallpaper(const QPoint &pos) const
+QRect MicaMaterialPrivate::mapToWallpaper(const QScreen *screen, const QRect &rect)
 {
-    if (pos.isNull()) {
+    Q_ASSERT(screen);
+    if (!screen) {
         return {};
     }
-    QPointF result = pos;
-    // Make sure the position is always inside the wallpaper rectangle.
-    while (result.x() < qreal(0)) {
-        result.setX(result.x() + wallpaperSize.width());
-    }
-    while ((result.x() > wallpaperSize.width()) || qFuzzyCompare(result.x(), wallpaperSize.width())) {
-        result.setX(result.x() - wallpaperSize.width());
-    }
-    while (result.y() < qreal(0)) {
-        result.setY(result.y() + wallpaperSize.height());
-    }
-    while ((result.y() > wallpaperSize.height()) || qFuzzyCompare(result.y(), wallpaperSize.height())) {
-        result.setY(result.y() - wallpaperSize.height());
-    }
-    return result.toPoint();
+    // The rectangle is in virtual desktop coordinates, while each screen
+    // has its own wallpaper which starts from its own top-left corner.
+    return rect.translated(-screen->geometry().topLeft());
 }
 
-QSize MicaMaterialPrivate::mapToWallpaper(const QSize &size) const
+QImage MicaMaterialPrivate::blurredImage(const QImage &image, const qreal radius, const bool transposed)
 {
-    if (size.isEmpty()) {
+    Q_ASSERT(!image.isNull());
+    if (image.isNull()) {
         return {};
     }
-    QSizeF result = size;
-    // Make sure we don't get a size larger than the wallpaper's size.
-    if (result.width() > wallpaperSize.width()) {
-        result.setWidth(wallpaperSize.width());
-    }
-    if (result.height() > wallpaperSize.height()) {
-        result.setHeight(wallpaperSize.height());
-    }
-    return result.toSize();
+#if FRAMELESSHELPER_CONFIG(private_qt)
+    QImage result = image.convertToFormat(kDefaultImageFormat);
+    qt_blurImage(result, radius, false, (transposed ? 1 : 0));
+    return result;
+#else // !FRAMELESSHELPER_CONFIG(private_qt)
+    Q_UNUSED(radius);
+    Q_UNUSED(transposed);
+    return image;
+#endif // FRAMELESSHELPER_CONFIG(private_qt)
 }
 
-QRect MicaMaterialPrivate::mapToWallpaper(const QRect &rect) const
+QImage MicaMaterialPrivate::blurredWallpaper(const QImage &image, const int scaleFactor)
 {
-    const auto wallpaperRect = QRectF{ QPointF{ 0, 0 }, wallpaperSize };
-    const auto mappedRect = QRectF{ mapToWallpaper(rect.topLeft()), mapToWallpaper(rect.size()) };
-    if (!Utils::isValidGeometry(mappedRect)) {
-        WARNING << "The calculated mapped rectangle is not valid.";
-        return wallpaperRect.toRect();
+    Q_ASSERT(!image.isNull());
+    Q_ASSERT(scaleFactor > 0);
+    if (image.isNull() || (scaleFactor <= 0)) {
+        return {};
     }
-    return mappedRect.toRect();
+#if FRAMELESSHELPER_CONFIG(private_qt)
+    int blurredScaleFactor = 1;
+    QImage result = qt_mipScaled(image.convertToFormat(kDefaultImageFormat), scaleFactor, &blurredScaleFactor);
+    qt_blurImage(result, (kDefaultBlurRadius / blurredScaleFactor), false);
+    return result;
+#else // !FRAMELESSHELPER_CONFIG(private_qt)
+    Q_UNUSED(scaleFactor);
+    return image;
+#endif // FRAMELESSHELPER_CONFIG(private_qt)
 }
 
 MicaMaterial::MicaMaterial(QObject *parent)
@@ -817,7 +2148,6 @@ void MicaMaterial::setTintColor(const QColor &value)
     if (d->tintColor == value) {
         return;
     }
-    d->prepareGraphicsResources();
     d->tintColor = value;
     d->updateMaterialBrush();
     Q_EMIT tintColorChanged();
@@ -835,7 +2165,6 @@ void MicaMaterial::setTintOpacity(const qreal value)
     if (qFuzzyCompare(d->tintOpacity, value)) {
         return;
     }
-    d->prepareGraphicsResources();
     d->tintOpacity = value;
     d->updateMaterialBrush();
     Q_EMIT tintOpacityChanged();
@@ -857,7 +2186,6 @@ void MicaMaterial::setFallbackColor(const QColor &value)
     if (d->fallbackColor == value) {
         return;
     }
-    d->prepareGraphicsResources();
     d->fallbackColor = value;
     d->updateMaterialBrush();
     Q_EMIT fallbackColorChanged();
@@ -875,7 +2203,6 @@ void MicaMaterial::setNoiseOpacity(const qreal value)
     if (qFuzzyCompare(d->noiseOpacity, value)) {
         return;
     }
-    d->prepareGraphicsResources();
     d->noiseOpacity = value;
     d->updateMaterialBrush();
     Q_EMIT noiseOpacityChanged();
@@ -893,12 +2220,46 @@ void MicaMaterial::setFallbackEnabled(const bool value)
     if (d->fallbackEnabled == value) {
         return;
     }
-    d->prepareGraphicsResources();
     d->fallbackEnabled = value;
     d->updateMaterialBrush();
     Q_EMIT fallbackEnabledChanged();
 }
 
+MicaQuality MicaMaterial::quality() const
+{
+    Q_D(const MicaMaterial);
+    return d->quality;
+}
+
+void MicaMaterial::setQuality(const MicaQuality value)
+{
+    Q_D(MicaMaterial);
+    if (d->quality == value) {
+        return;
+    }
+    d->quality = value;
+    Q_EMIT qualityChanged();
+    // The surface of the new quality will be requested by the next paint.
+    Q_EMIT shouldRedraw();
+}
+
+quint64 MicaMaterial::contendedPaintCount()
+{
+    return g_imageData()->contendedPaintCount.load(std::memory_order_relaxed);
+}
+
+int MicaMaterial::blurThreadCount()
+{
+    return effectiveBlurThreadCount();
+}
+
+void MicaMaterial::setBlurThreadCount(const int value)
+{
+    g_blurThreadData()->threadCount.store(std::max(value, 0), std::memory_order_relaxed);
+    // The thread that generates the wallpaper blurs one band by itself, the pool only needs the rest.
+    g_blurThreadData()->threadPool.setMaxThreadCount(std::max((effectiveBlurThreadCount() - 1), 1));
+}
+
 void MicaMaterial::paint(QPainter *painter, const QRect &rect, const bool active)
 {
     Q_ASSERT(painter);
@@ -906,53 +2267,48 @@ void MicaMaterial::paint(QPainter *painter, const QRect &rect, const bool active
         return;
     }
     Q_D(MicaMaterial);
-    d->prepareGraphicsResources();
     static constexpr const auto originPoint = QPoint{ 0, 0 };
-    const QRect wallpaperRect = { originPoint, d->wallpaperSize };
-    const QRect mappedRect = d->mapToWallpaper(rect);
     painter->save();
     // Same as above. Speed is more important here.
     painter->setRenderHint(QPainter::Antialiasing, false);
     painter->setRenderHint(QPainter::TextAntialiasing, false);
     painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
     if (active) {
-        const QRect intersectedRect = wallpaperRect.intersected(mappedRect);
-        g_imageData()->mutex.lock();
-        painter->drawPixmap(originPoint, g_imageData()->blurredWallpaper, intersectedRect);
-        g_imageData()->mutex.unlock();
-        if (intersectedRect != mappedRect) {
-            static constexpr const auto xOffset = QPoint{ 1, 0 };
-            if (mappedRect.y() + mappedRect.height() <= wallpaperRect.height()) {
-                const QRect outerRect = { intersectedRect.topRight() + xOffset, QSize{ mappedRect.width() - intersectedRect.width(), intersectedRect.height() } };
-                const QPoint outerRectOriginPoint = originPoint + QPoint{ intersectedRect.width(), 0 } + xOffset;
-                const QRect mappedOuterRect = d->mapToWallpaper(outerRect);
-                const QMutexLocker locker(&g_imageData()->mutex);
-                painter->drawPixmap(outerRectOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRect);
-            } else {
-                static constexpr const auto yOffset = QPoint{ 0, 1 };
-                const QRect outerRectBottom = { intersectedRect.bottomLeft() + yOffset, QSize{ intersectedRect.width(), mappedRect.height() - intersectedRect.height() } };
-                const QPoint outerRectBottomOriginPoint = originPoint + QPoint{ 0, intersectedRect.height() } + yOffset;
-                const QRect mappedOuterRectBottom = d->mapToWallpaper(outerRectBottom);
-                g_imageData()->mutex.lock();
-                painter->drawPixmap(outerRectBottomOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRectBottom);
-                g_imageData()->mutex.unlock();
-                if (mappedRect.x() + mappedRect.width() > wallpaperRect.width()) {
-                    const QRect outerRectRight = { intersectedRect.topRight() + xOffset, QSize{ mappedRect.width() - intersectedRect.width(), intersectedRect.height() } };
-                    const QPoint outerRectRightOriginPoint = originPoint + QPoint{ intersectedRect.width(), 0 } + xOffset;
-                    const QRect mappedOuterRectRight = d->mapToWallpaper(outerRectRight);
-                    const QRect outerRectCorner = { intersectedRect.bottomRight() + xOffset + yOffset, QSize{ outerRectRight.width(), outerRectBottom.height() } };
-                    const QPoint outerRectCornerOriginPoint = originPoint + QPoint{ intersectedRect.width(), intersectedRect.height() } + xOffset + yOffset;
-                    const QRect mappedOuterRectCorner = d->mapToWallpaper(outerRectCorner);
-                    const QMutexLocker locker(&g_imageData()->mutex);
-                    painter->drawPixmap(outerRectRightOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRectRight);
-                    painter->drawPixmap(outerRectCornerOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRectCorner);
+        if (const QScreen * const screen = MicaMaterialPrivate::findScreen(rect)) {
+            if (g_imageData()->blurring.load(std::memory_order_relaxed)) {
+                g_imageData()->contendedPaintCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            const QString key = wallpaperSurfaceKey(screen->name(), d->quality);
+            // The snapshot never changes, no lock needed.
+            WallpaperSurfacesPointer surfaces = loadWallpaperSurfaces();
+            auto it = surfaces->constFind(key);
+            if ((it == surfaces->constEnd()) || !isSameWallpaperScreen(it->screen, wallpaperScreen(screen, d->quality))) {
+                // Rare: the first paint on this screen, or the screen has changed.
+                d->maybeGenerateBlurredWallpaper(screen);
+                surfaces = loadWallpaperSurfaces();
+                it = surfaces->constFind(key);
+            }
+            const QRect mappedRect = MicaMaterialPrivate::mapToWallpaper(screen, rect);
+            if ((it != surfaces->constEnd()) && !it->image.isNull() && !it->size.isEmpty()) {
+                // The part that goes beyond the screen has nothing to show.
+                const QRect visibleRect = mappedRect.intersected(QRect{ originPoint, it->size });
+                if (!visibleRect.isEmpty()) {
+                    const qreal xScale = (qreal(it->image.width()) / qreal(it->size.width()));
+                    const qreal yScale = (qreal(it->image.height()) / qreal(it->size.height()));
+                    const QRectF sourceRect = { (visibleRect.x() * xScale), (visibleRect.y() * yScale),
+                        (visibleRect.width() * xScale), (visibleRect.height() * yScale) };
+                    const QRectF targetRect = visibleRect.translated(-mappedRect.topLeft());
+                    // The surface is a downsampled blur, bilinear filtering reconstructs it smoothly.
+                    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+                    painter->drawImage(targetRect, it->image, sourceRect);
+                    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
                 }
             }
         }
     }
     painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
     painter->setOpacity(qreal(1));
-    painter->fillRect(QRect{originPoint, mappedRect.size()}, [d, active]() -> QBrush {
+    painter->fillRect(QRect{originPoint, rect.size()}, [d, active]() -> QBrush {
         if (!d->fallbackEnabled || active) {
             return d->micaBrush;
         }
@@ -26,6 +26,7 @@
 
 #include "framelesshelper_linux.h"
 #include "sysapiloader_p.h"
+#include "framelesshelpercore_global_p.h"
 
 //////////////////////////////////////////////
 // Xlib
@@ -58,22 +59,25 @@ XInitThreads(
 
 FRAMELESSHELPER_STRING_CONSTANT(libxcb)
 
-FRAMELESSHELPER_STRING_CONSTANT(xcb_send_event)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_flush)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_intern_atom)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_intern_atom_reply)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_ungrab_pointer)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_change_property)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_delete_property_checked)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_get_property)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_get_property_reply)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_get_property_value)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_get_property_value_length)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_list_properties)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_list_properties_reply)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_list_properties_atoms_length)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_list_properties_atoms)
-FRAMELESSHELPER_STRING_CONSTANT(xcb_get_property_unchecked)
+#define XCB_SYMBOLS(X) \
+  X(xcb_send_event) \
+  X(xcb_flush) \
+  X(xcb_intern_atom) \
+  X(xcb_intern_atom_reply) \
+  X(xcb_ungrab_pointer) \
+  X(xcb_change_property) \
+  X(xcb_delete_property_checked) \
+  X(xcb_get_property) \
+  X(xcb_get_property_reply) \
+  X(xcb_get_property_value) \
+  X(xcb_get_property_value_length) \
+  X(xcb_list_properties) \
+  X(xcb_list_properties_reply) \
+  X(xcb_list_properties_atoms_length) \
+  X(xcb_list_properties_atoms) \
+  X(xcb_get_property_unchecked)
+
+API_DECLARE_SYMBOL_TABLE(libxcb, XCB_SYMBOLS)
 
 extern "C" xcb_void_cookie_t
 xcb_send_event(
@@ -84,10 +88,10 @@ xcb_send_event(
     const char *event
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_send_event)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_send_event)) {
         return {};
     }
-    return API_CALL_FUNCTION(libxcb, xcb_send_event, connection, propagate, destination, event_mask, event);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_send_event, connection, propagate, destination, event_mask, event);
 }
 
 extern "C" int
@@ -95,10 +99,10 @@ xcb_flush(
     xcb_connection_t *connection
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_flush)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_flush)) {
         return 0;
     }
-    return API_CALL_FUNCTION(libxcb, xcb_flush, connection);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_flush, connection);
 }
 
 extern "C" xcb_intern_atom_cookie_t
@@ -109,10 +113,10 @@ xcb_intern_atom(
     const char *name
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_intern_atom)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_intern_atom)) {
         return {};
     }
-    return API_CALL_FUNCTION(libxcb, xcb_intern_atom, connection, only_if_exists, name_len, name);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_intern_atom, connection, only_if_exists, name_len, name);
 }
 
 extern "C" xcb_intern_atom_reply_t *
@@ -122,10 +126,10 @@ xcb_intern_atom_reply(
     xcb_generic_error_t **error
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_intern_atom_reply)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_intern_atom_reply)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libxcb, xcb_intern_atom_reply, connection, cookie, error);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_intern_atom_reply, connection, cookie, error);
 }
 
 extern "C" xcb_void_cookie_t
@@ -134,10 +138,10 @@ xcb_ungrab_pointer(
     xcb_timestamp_t time
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_ungrab_pointer)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_ungrab_pointer)) {
         return {};
     }
-    return API_CALL_FUNCTION(libxcb, xcb_ungrab_pointer, connection, time);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_ungrab_pointer, connection, time);
 }
 
 extern "C" xcb_void_cookie_t
@@ -152,10 +156,10 @@ xcb_change_property(
     const void *data
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_change_property)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_change_property)) {
         return {};
     }
-    return API_CALL_FUNCTION(libxcb, xcb_change_property, connection,
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_change_property, connection,
         mode, window, property, type, format, data_len, data);
 }
 
@@ -166,10 +170,10 @@ xcb_delete_property_checked(
     xcb_atom_t property
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_delete_property_checked)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_delete_property_checked)) {
         return {};
     }
-    return API_CALL_FUNCTION(libxcb, xcb_delete_property_checked, connection, window, property);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_delete_property_checked, connection, window, property);
 }
 
 extern "C" xcb_get_property_cookie_t
@@ -183,10 +187,10 @@ xcb_get_property(
     uint32_t long_length
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_get_property)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_get_property)) {
         return {};
     }
-    return API_CALL_FUNCTION(libxcb, xcb_get_property, connection,
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_get_property, connection,
         _delete, window, property, type, long_offset, long_length);
 }
 
@@ -197,10 +201,10 @@ xcb_get_property_reply(
     xcb_generic_error_t **error
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_get_property_reply)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_get_property_reply)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libxcb, xcb_get_property_reply, connection, cookie, error);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_get_property_reply, connection, cookie, error);
 }
 
 extern "C" void *
@@ -208,10 +212,10 @@ xcb_get_property_value(
     const xcb_get_property_reply_t *reply
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_get_property_value)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_get_property_value)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libxcb, xcb_get_property_value, reply);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_get_property_value, reply);
 }
 
 extern "C" int
@@ -219,10 +223,10 @@ xcb_get_property_value_length(
     const xcb_get_property_reply_t *reply
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_get_property_value_length)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_get_property_value_length)) {
         return 0;
     }
-    return API_CALL_FUNCTION(libxcb, xcb_get_property_value_length, reply);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_get_property_value_length, reply);
 }
 
 extern "C" xcb_list_properties_cookie_t
@@ -231,10 +235,10 @@ xcb_list_properties(
     xcb_window_t window
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_list_properties)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_list_properties)) {
         return {};
     }
-    return API_CALL_FUNCTION(libxcb, xcb_list_properties, connection, window);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_list_properties, connection, window);
 }
 
 extern "C" xcb_list_properties_reply_t *
@@ -244,10 +248,10 @@ xcb_list_properties_reply(
     xcb_generic_error_t **error
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_list_properties_reply)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_list_properties_reply)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libxcb, xcb_list_properties_reply, connection, cookie, error);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_list_properties_reply, connection, cookie, error);
 }
 
 extern "C" int
@@ -255,10 +259,10 @@ xcb_list_properties_atoms_length(
     const xcb_list_properties_reply_t *atom
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_list_properties_atoms_length)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_list_properties_atoms_length)) {
         return 0;
     }
-    return API_CALL_FUNCTION(libxcb, xcb_list_properties_atoms_length, atom);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_list_properties_atoms_length, atom);
 }
 
 extern "C" xcb_atom_t *
@@ -266,10 +270,10 @@ xcb_list_properties_atoms(
     const xcb_list_properties_reply_t *atom
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_list_properties_atoms)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_list_properties_atoms)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libxcb, xcb_list_properties_atoms, atom);
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_list_properties_atoms, atom);
 }
 
 extern "C" xcb_get_property_cookie_t
@@ -283,10 +287,10 @@ xcb_get_property_unchecked(
     uint32_t long_length
 )
 {
-    if (!API_XCB_AVAILABLE(xcb_get_property_unchecked)) {
+    if (!API_SYMBOL_AVAILABLE(libxcb, xcb_get_property_unchecked)) {
         return {};
     }
-    return API_CALL_FUNCTION(libxcb, xcb_get_property_unchecked, connection,
+    return API_SYMBOL_CALL_FUNCTION(libxcb, xcb_get_property_unchecked, connection,
             _delete, window, property, type, long_offset, long_length);
 }
 
@@ -319,18 +323,21 @@ xcb_get_property_unchecked(
 
 FRAMELESSHELPER_STRING_CONSTANT2(libgtk, "libgtk-3")
 
-FRAMELESSHELPER_STRING_CONSTANT(gtk_init)
-FRAMELESSHELPER_STRING_CONSTANT(g_value_init)
-FRAMELESSHELPER_STRING_CONSTANT(g_value_reset)
-FRAMELESSHELPER_STRING_CONSTANT(g_value_unset)
-FRAMELESSHELPER_STRING_CONSTANT(g_value_get_boolean)
-FRAMELESSHELPER_STRING_CONSTANT(g_value_get_string)
-FRAMELESSHELPER_STRING_CONSTANT(gtk_settings_get_default)
-FRAMELESSHELPER_STRING_CONSTANT(g_object_get_property)
-FRAMELESSHELPER_STRING_CONSTANT(g_signal_connect_data)
-FRAMELESSHELPER_STRING_CONSTANT(g_free)
-FRAMELESSHELPER_STRING_CONSTANT(g_object_unref)
-FRAMELESSHELPER_STRING_CONSTANT(g_clear_object)
+#define GTK_SYMBOLS(X) \
+  X(gtk_init) \
+  X(g_value_init) \
+  X(g_value_reset) \
+  X(g_value_unset) \
+  X(g_value_get_boolean) \
+  X(g_value_get_string) \
+  X(gtk_settings_get_default) \
+  X(g_object_get_property) \
+  X(g_signal_connect_data) \
+  X(g_free) \
+  X(g_object_unref) \
+  X(g_clear_object)
+
+API_DECLARE_SYMBOL_TABLE(libgtk, GTK_SYMBOLS)
 
 extern "C" void
 gtk_init(
@@ -338,10 +345,10 @@ gtk_init(
     char ***argv
 )
 {
-    if (!API_GTK_AVAILABLE(gtk_init)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, gtk_init)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, gtk_init, argc, argv);
+    API_SYMBOL_CALL_FUNCTION(libgtk, gtk_init, argc, argv);
 }
 
 extern "C" GValue *
@@ -350,10 +357,10 @@ g_value_init(
     GType g_type
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_init)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_value_init)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libgtk, g_value_init, value, g_type);
+    return API_SYMBOL_CALL_FUNCTION(libgtk, g_value_init, value, g_type);
 }
 
 extern "C" GValue *
@@ -361,10 +368,10 @@ g_value_reset(
     GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_reset)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_value_reset)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libgtk, g_value_reset, value);
+    return API_SYMBOL_CALL_FUNCTION(libgtk, g_value_reset, value);
 }
 
 extern "C" void
@@ -372,10 +379,10 @@ g_value_unset(
     GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_unset)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_value_unset)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_value_unset, value);
+    API_SYMBOL_CALL_FUNCTION(libgtk, g_value_unset, value);
 }
 
 extern "C" gboolean
@@ -383,10 +390,10 @@ g_value_get_boolean(
     const GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_get_boolean)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_value_get_boolean)) {
         return false;
     }
-    return API_CALL_FUNCTION(libgtk, g_value_get_boolean, value);
+    return API_SYMBOL_CALL_FUNCTION(libgtk, g_value_get_boolean, value);
 }
 
 extern "C" const gchar *
@@ -394,10 +401,10 @@ g_value_get_string(
     const GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_get_string)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_value_get_string)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libgtk, g_value_get_string, value);
+    return API_SYMBOL_CALL_FUNCTION(libgtk, g_value_get_string, value);
 }
 
 extern "C" GtkSettings *
@@ -405,10 +412,10 @@ gtk_settings_get_default(
     void
 )
 {
-    if (!API_GTK_AVAILABLE(gtk_settings_get_default)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, gtk_settings_get_default)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libgtk, gtk_settings_get_default);
+    return API_SYMBOL_CALL_FUNCTION(libgtk, gtk_settings_get_default);
 }
 
 extern "C" void
@@ -418,10 +425,10 @@ g_object_get_property(
     GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_object_get_property)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_object_get_property)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_object_get_property, object, property_name, value);
+    API_SYMBOL_CALL_FUNCTION(libgtk, g_object_get_property, object, property_name, value);
 }
 
 extern "C" gulong
@@ -434,10 +441,10 @@ g_signal_connect_data(
     GConnectFlags connect_flags
 )
 {
-    if (!API_GTK_AVAILABLE(g_signal_connect_data)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_signal_connect_data)) {
         return 0;
     }
-    return API_CALL_FUNCTION(libgtk, g_signal_connect_data, instance, detailed_signal, c_handler, data, destroy_data, connect_flags);
+    return API_SYMBOL_CALL_FUNCTION(libgtk, g_signal_connect_data, instance, detailed_signal, c_handler, data, destroy_data, connect_flags);
 }
 
 extern "C" void
@@ -445,10 +452,10 @@ g_free(
     gpointer mem
 )
 {
-    if (!API_GTK_AVAILABLE(g_free)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_free)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_free, mem);
+    API_SYMBOL_CALL_FUNCTION(libgtk, g_free, mem);
 }
 
 extern "C" void
@@ -456,10 +463,10 @@ g_object_unref(
     GObject *object
 )
 {
-    if (!API_GTK_AVAILABLE(g_object_unref)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_object_unref)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_object_unref, object);
+    API_SYMBOL_CALL_FUNCTION(libgtk, g_object_unref, object);
 }
 
 extern "C" void
@@ -467,10 +474,10 @@ g_clear_object(
     GObject **object_ptr
 )
 {
-    if (!API_GTK_AVAILABLE(g_clear_object)) {
+    if (!API_SYMBOL_AVAILABLE(libgtk, g_clear_object)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_clear_object, object_ptr);
+    API_SYMBOL_CALL_FUNCTION(libgtk, g_clear_object, object_ptr);
 }
 
 GTKSETTINGS_IMPL(bool, const bool result = g_value_get_boolean(&value);)
@@ -510,6 +517,16 @@ QString gtkSettings(const gchar *property)
     g_free(raw);
     return result;
 }
+
+void FramelessHelperPreloadSystemLibraries()
+{
+#ifndef FRAMELESSHELPER_HAS_XCB
+    API_PRELOAD_SYMBOL_TABLE(libxcb, XCB_SYMBOLS);
+#endif // FRAMELESSHELPER_HAS_XCB
+#ifndef FRAMELESSHELPER_HAS_GTK
+    API_PRELOAD_SYMBOL_TABLE(libgtk, GTK_SYMBOLS);
+#endif // FRAMELESSHELPER_HAS_GTK
+}
 FRAMELESSHELPER_END_NAMESPACE
 
 #endif // __linux__
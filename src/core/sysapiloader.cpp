@@ -44,10 +44,16 @@
 #  define SYSAPILOADER_QLIBRARY ((SYSAPILOADER_IMPL) == 2)
 #endif // SYSAPILOADER_QLIBRARY
 
+#include "atomicsharedptr_p.h"
 #include <QtCore/qhash.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qvarlengtharray.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qmutex.h>
+#include <algorithm>
+#include <memory>
 #if SYSAPILOADER_QSYSTEMLIBRARY
 #  include <QtCore/private/qsystemlibrary_p.h>
 #endif // SYSAPILOADER_QSYSTEMLIBRARY
@@ -71,8 +77,40 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 #endif
 
 using SysApiLoaderData = QHash<QString, QFunctionPointer>;
+using SysApiLoaderDataPointer = std::shared_ptr<const SysApiLoaderData>;
 
-Q_GLOBAL_STATIC(SysApiLoaderData, g_sysApiLoaderData)
+struct SysApiLoaderCache
+{
+    // Functions are only ever added, and only once. Lookups load an immutable snapshot and
+    // never take the mutex, writers swap in a modified copy while holding it. That way the
+    // platform APIs can be used from any thread, not only the GUI thread.
+    AtomicSharedPtr<const SysApiLoaderData> symbols{ std::make_shared<const SysApiLoaderData>() };
+    QMutex mutex{};
+};
+
+Q_GLOBAL_STATIC(SysApiLoaderCache, g_sysApiLoaderData)
+
+[[nodiscard]] static inline SysApiLoaderDataPointer loadCachedSymbols()
+{
+    return g_sysApiLoaderData()->symbols.load();
+}
+
+// Functions resolved by another thread in the mean time are kept, the results are the same anyway.
+static inline void cacheResolvedSymbols(const SysApiLoaderData &symbols)
+{
+    if (symbols.isEmpty()) {
+        return;
+    }
+    const QMutexLocker locker(&g_sysApiLoaderData()->mutex);
+    const SysApiLoaderDataPointer oldSymbols = loadCachedSymbols();
+    auto newSymbols = std::make_shared<SysApiLoaderData>(*oldSymbols);
+    for (auto it = symbols.constBegin(); it != symbols.constEnd(); ++it) {
+        if (!newSymbols->contains(it.key())) {
+            newSymbols->insert(it.key(), it.value());
+        }
+    }
+    g_sysApiLoaderData()->symbols.store(std::move(newSymbols));
+}
 
 #if FRAMELESSHELPER_CONFIG(debug_output)
 [[nodiscard]] static inline bool isDebug()
@@ -82,6 +120,45 @@ Q_GLOBAL_STATIC(SysApiLoaderData, g_sysApiLoaderData)
 }
 #endif
 
+// Opens the library only once and resolves all the given functions from it. Doesn't
+// touch the cache, so it's fine to call it from any thread.
+[[nodiscard]] static inline SysApiLoaderData resolveLibrary(const QString &library, const QByteArrayList &functions)
+{
+    Q_ASSERT(!library.isEmpty());
+    Q_ASSERT(!functions.isEmpty());
+    if (library.isEmpty() || functions.isEmpty()) {
+        return {};
+    }
+    QElapsedTimer timer = {};
+    timer.start();
+#if SYSAPILOADER_QSYSTEMLIBRARY
+    QSystemLibrary lib(library);
+#endif // SYSAPILOADER_QSYSTEMLIBRARY
+#if SYSAPILOADER_QLIBRARY
+    QLibrary lib(library);
+#endif // SYSAPILOADER_QLIBRARY
+    // The library is never unloaded, just like what the static resolve() functions do.
+    const bool loaded = lib.load();
+    if (!loaded) {
+        WARNING << "Failed to load" << library;
+    }
+    SysApiLoaderData result = {};
+    result.reserve(functions.size());
+    int resolvedCount = 0;
+    for (auto &&function : std::as_const(functions)) {
+        const QFunctionPointer symbol = (loaded ? lib.resolve(function.constData()) : nullptr);
+        if (symbol) {
+            ++resolvedCount;
+        } else if (loaded) {
+            WARNING << "Failed to load" << function << "from" << library;
+        }
+        result.insert(SysApiLoader::generateUniqueKey(library, QString::fromLatin1(function)), symbol);
+    }
+    DEBUG << "Resolved" << resolvedCount << "of" << functions.size() << "functions from"
+          << library << "in" << timer.nsecsElapsed() << "ns.";
+    return result;
+}
+
 SysApiLoader::SysApiLoader(QObject *parent) : QObject(parent)
 {
 }
@@ -186,8 +263,9 @@ bool SysApiLoader::isAvailable(const QString &library, const QString &function)
         return false;
     }
     const QString key = generateUniqueKey(library, function);
-    const auto it = g_sysApiLoaderData()->constFind(key);
-    if (it != g_sysApiLoaderData()->constEnd()) {
+    const SysApiLoaderDataPointer symbols = loadCachedSymbols();
+    const auto it = symbols->constFind(key);
+    if (it != symbols->constEnd()) {
 #if FRAMELESSHELPER_CONFIG(debug_output)
         if (isDebug()) {
             DEBUG << Q_FUNC_INFO << "Function cache found:" << key;
@@ -196,7 +274,7 @@ bool SysApiLoader::isAvailable(const QString &library, const QString &function)
         return (it.value() != nullptr);
     } else {
         const QFunctionPointer symbol = SysApiLoader::resolve(library, function);
-        g_sysApiLoaderData()->insert(key, symbol);
+        cacheResolvedSymbols({ { key, symbol } });
 #if FRAMELESSHELPER_CONFIG(debug_output)
         if (isDebug()) {
             DEBUG << Q_FUNC_INFO << "New function cache:" << key << (symbol ? "[VALID]" : "[NULL]");
@@ -212,6 +290,51 @@ bool SysApiLoader::isAvailable(const QString &library, const QString &function)
     }
 }
 
+bool SysApiLoader::preload(const QString &library, const QByteArrayList &functions)
+{
+    Q_ASSERT(!library.isEmpty());
+    Q_ASSERT(!functions.isEmpty());
+    if (library.isEmpty() || functions.isEmpty()) {
+        return false;
+    }
+    // Most likely preloaded by preloadAsync() already.
+    {
+        const SysApiLoaderDataPointer cachedSymbols = loadCachedSymbols();
+        bool allCached = true;
+        bool allResolved = true;
+        for (auto &&function : std::as_const(functions)) {
+            const auto it = cachedSymbols->constFind(generateUniqueKey(library, QString::fromLatin1(function)));
+            if (it == cachedSymbols->constEnd()) {
+                allCached = false;
+                break;
+            }
+            allResolved = (allResolved && (it.value() != nullptr));
+        }
+        if (allCached) {
+            return allResolved;
+        }
+    }
+    const SysApiLoaderData symbols = resolveLibrary(library, functions);
+    cacheResolvedSymbols(symbols);
+    return std::all_of(symbols.constBegin(), symbols.constEnd(), [](const QFunctionPointer symbol){ return (symbol != nullptr); });
+}
+
+void SysApiLoader::preloadAsync(const QString &library, const QByteArrayList &functions)
+{
+    Q_ASSERT(!library.isEmpty());
+    Q_ASSERT(!functions.isEmpty());
+    if (library.isEmpty() || functions.isEmpty()) {
+        return;
+    }
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+    QThreadPool::globalInstance()->start([library, functions](){
+        cacheResolvedSymbols(resolveLibrary(library, functions));
+    });
+#else // (QT_VERSION < QT_VERSION_CHECK(5, 15, 0))
+    std::ignore = preload(library, functions);
+#endif // (QT_VERSION >= QT_VERSION_CHECK(5, 15, 0))
+}
+
 QFunctionPointer SysApiLoader::get(const QString &library, const QString &function)
 {
     Q_ASSERT(!library.isEmpty());
@@ -220,8 +343,9 @@ QFunctionPointer SysApiLoader::get(const QString &library, const QString &functi
         return nullptr;
     }
     const QString key = generateUniqueKey(library, function);
-    const auto it = g_sysApiLoaderData()->constFind(key);
-    if (it != g_sysApiLoaderData()->constEnd()) {
+    const SysApiLoaderDataPointer symbols = loadCachedSymbols();
+    const auto it = symbols->constFind(key);
+    if (it != symbols->constEnd()) {
 #if FRAMELESSHELPER_CONFIG(debug_output)
         if (isDebug()) {
             DEBUG << Q_FUNC_INFO << "Function cache found:" << key;
@@ -29,8 +29,17 @@
 #include "framelessconfig_p.h"
 #include "framelessmanager.h"
 #include "framelessmanager_p.h"
-#include <cstring> // for std::memcpy
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qset.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qabstractnativeeventfilter.h>
 #include <QtGui/qevent.h>
 #include <QtGui/qwindow.h>
 #include <QtGui/qscreen.h>
@@ -90,6 +99,262 @@ static constexpr const auto _XCB_SEND_EVENT_MASK =
 extern template bool gtkSettings<bool>(const gchar *);
 extern QString gtkSettings(const gchar *);
 
+// All the atoms we know about, see the ATOM_* constants.
+#define X11_ATOMS(X) \
+  X(NET_SUPPORTED) \
+  X(NET_WM_NAME) \
+  X(NET_WM_MOVERESIZE) \
+  X(NET_SUPPORTING_WM_CHECK) \
+  X(NET_KDE_COMPOSITE_TOGGLING) \
+  X(KDE_NET_WM_BLUR_BEHIND_REGION) \
+  X(GTK_SHOW_WINDOW_MENU) \
+  X(DEEPIN_NO_TITLEBAR) \
+  X(DEEPIN_FORCE_DECORATE) \
+  X(NET_WM_DEEPIN_BLUR_REGION_MASK) \
+  X(NET_WM_DEEPIN_BLUR_REGION_ROUNDED) \
+  X(UTF8_STRING)
+
+#define X11_ATOM_ENTRY(atom) atom,
+#define X11_ATOM_NAME(atom) ATOM_##atom,
+
+enum class X11Atom : quint8
+{
+    X11_ATOMS(X11_ATOM_ENTRY)
+};
+
+[[maybe_unused]] static constexpr const std::array kX11AtomNames = { X11_ATOMS(X11_ATOM_NAME) };
+
+using X11Atoms = std::array<xcb_atom_t, kX11AtomNames.size()>;
+
+[[nodiscard]] static inline X11Atoms internKnownAtoms()
+{
+    X11Atoms atoms = {};
+    xcb_connection_t * const connection = Utils::x11_connection();
+    Q_ASSERT(connection);
+    if (!connection) {
+        return atoms;
+    }
+    QElapsedTimer timer = {};
+    timer.start();
+    // Send all the requests first and only then wait for the replies, so that
+    // the whole set costs one round trip to the X server instead of one per atom.
+    std::array<xcb_intern_atom_cookie_t, kX11AtomNames.size()> cookies = {};
+    for (std::size_t index = 0; index != kX11AtomNames.size(); ++index) {
+        const char * const name = kX11AtomNames[index];
+        cookies[index] = xcb_intern_atom(connection, false, qstrlen(name), name);
+    }
+    for (std::size_t index = 0; index != kX11AtomNames.size(); ++index) {
+        xcb_intern_atom_reply_t * const reply = xcb_intern_atom_reply(connection, cookies[index], nullptr);
+        if (!reply) {
+            WARNING << "Failed to intern the atom" << kX11AtomNames[index];
+            continue;
+        }
+        atoms[index] = reply->atom;
+        std::free(reply);
+    }
+    DEBUG << "Interning" << kX11AtomNames.size() << "atoms took" << timer.nsecsElapsed() << "ns.";
+    return atoms;
+}
+
+[[nodiscard]] static inline xcb_atom_t x11Atom(const X11Atom atom)
+{
+    static const X11Atoms atoms = internKnownAtoms();
+    return atoms[static_cast<std::size_t>(atom)];
+}
+
+using X11AtomSet = QSet<xcb_atom_t>;
+
+class X11RootWindowWatcher : public QAbstractNativeEventFilter
+{
+public:
+    explicit X11RootWindowWatcher(const xcb_window_t rootWindow)
+        : m_rootWindow(rootWindow)
+        , m_netSupportedAtom(x11Atom(X11Atom::NET_SUPPORTED))
+        , m_netSupportingWmCheckAtom(x11Atom(X11Atom::NET_SUPPORTING_WM_CHECK)) {}
+    ~X11RootWindowWatcher() override = default;
+
+    [[nodiscard]] bool nativeEventFilter(const QByteArray &eventType, void *message, QT_NATIVE_EVENT_RESULT_TYPE *result) override;
+
+private:
+    xcb_window_t m_rootWindow = XCB_WINDOW_NONE;
+    // Looked up once, handling an event never needs to intern any atoms.
+    xcb_atom_t m_netSupportedAtom = XCB_NONE;
+    xcb_atom_t m_netSupportingWmCheckAtom = XCB_NONE;
+};
+
+struct X11RootWindowData
+{
+    // Both are fetched again after the root window tells us they may have changed,
+    // for example because the window manager has been replaced.
+    std::optional<X11AtomSet> netSupportedAtoms = std::nullopt;
+    std::optional<X11AtomSet> rootWindowProperties = std::nullopt;
+    // Only touched on the thread of the application object, see installRootWindowWatcher().
+    std::unique_ptr<X11RootWindowWatcher> watcher = nullptr;
+    std::atomic<bool> watcherRequested = false;
+    QMutex mutex{};
+};
+
+Q_GLOBAL_STATIC(X11RootWindowData, g_x11RootWindowData)
+
+bool X11RootWindowWatcher::nativeEventFilter(const QByteArray &eventType, void *message, QT_NATIVE_EVENT_RESULT_TYPE *result)
+{
+    Q_UNUSED(result);
+    if ((eventType != "xcb_generic_event_t") || !message) {
+        return false;
+    }
+    const auto event = static_cast<const xcb_generic_event_t *>(message);
+    if ((event->response_type & ~0x80) != XCB_PROPERTY_NOTIFY) {
+        return false;
+    }
+    const auto propertyEvent = reinterpret_cast<const xcb_property_notify_event_t *>(event);
+    if (propertyEvent->window != m_rootWindow) {
+        return false;
+    }
+    const xcb_atom_t atom = propertyEvent->atom;
+    X11RootWindowData * const data = g_x11RootWindowData();
+    const QMutexLocker locker(&data->mutex);
+    // A (new) window manager announces itself and what it supports through these two.
+    if ((atom == m_netSupportedAtom) || (atom == m_netSupportingWmCheckAtom)) {
+        data->netSupportedAtoms.reset();
+    }
+    // The property list only changes when a property appears or disappears, not when its value changes.
+    if (data->rootWindowProperties.has_value()) {
+        const bool known = data->rootWindowProperties->contains(atom);
+        if ((propertyEvent->state == XCB_PROPERTY_DELETE) ? known : !known) {
+            data->rootWindowProperties.reset();
+        }
+    }
+    return false;
+}
+
+static inline void uninstallRootWindowWatcher()
+{
+    if (g_x11RootWindowData.isDestroyed()) {
+        return;
+    }
+    X11RootWindowData * const data = g_x11RootWindowData();
+    if (!data->watcher) {
+        return;
+    }
+    // Not available anymore once the application object is being destroyed.
+    if (QCoreApplication * const app = QCoreApplication::instance()) {
+        app->removeNativeEventFilter(data->watcher.get());
+    }
+    data->watcher.reset();
+}
+
+// Must be called on the thread of the application object.
+static inline void installRootWindowWatcherNow()
+{
+    QCoreApplication * const app = QCoreApplication::instance();
+    if (!app || g_x11RootWindowData.isDestroyed()) {
+        return;
+    }
+    X11RootWindowData * const data = g_x11RootWindowData();
+    const xcb_window_t rootWindow = Utils::x11_appRootWindow(Utils::x11_appScreen());
+    if (!rootWindow) {
+        // Try again next time.
+        data->watcherRequested.store(false, std::memory_order_release);
+        return;
+    }
+    // Qt's XCB plugin already selects the property change events of the root window.
+    data->watcher = std::make_unique<X11RootWindowWatcher>(rootWindow);
+    app->installNativeEventFilter(data->watcher.get());
+    // Don't leave it to the static destructors, the event dispatcher is long gone by then.
+    QObject::connect(app, &QCoreApplication::aboutToQuit, &uninstallRootWindowWatcher);
+    QObject::connect(app, &QObject::destroyed, &uninstallRootWindowWatcher);
+}
+
+// Native events are only delivered to the thread of the application object, so the
+// watcher is installed (and removed again before the application goes away) there.
+// The caller must not hold the mutex.
+static inline void installRootWindowWatcher()
+{
+    QCoreApplication * const app = QCoreApplication::instance();
+    if (!app) {
+        return;
+    }
+    X11RootWindowData * const data = g_x11RootWindowData();
+    if (data->watcherRequested.load(std::memory_order_acquire) || data->watcherRequested.exchange(true)) {
+        return;
+    }
+    if (QThread::currentThread() == app->thread()) {
+        installRootWindowWatcherNow();
+    } else {
+        QTimer::singleShot(0, app, &installRootWindowWatcherNow);
+    }
+}
+
+[[nodiscard]] static inline X11AtomSet fetchNetSupportedAtoms()
+{
+    xcb_connection_t * const connection = Utils::x11_connection();
+    Q_ASSERT(connection);
+    if (!connection) {
+        return {};
+    }
+    const quint32 rootWindow = Utils::x11_appRootWindow(Utils::x11_appScreen());
+    Q_ASSERT(rootWindow);
+    if (!rootWindow) {
+        return {};
+    }
+    const xcb_atom_t netSupportedAtom = x11Atom(X11Atom::NET_SUPPORTED);
+    if (netSupportedAtom == XCB_NONE) {
+        WARNING << "Failed to retrieve the atom of _NET_SUPPORTED.";
+        return {};
+    }
+    X11AtomSet result = {};
+    int offset = 0;
+    int remaining = 0;
+    do {
+        const xcb_get_property_cookie_t cookie = xcb_get_property(connection, false, rootWindow, netSupportedAtom, XCB_ATOM_ATOM, offset, 1024);
+        xcb_get_property_reply_t * const reply = xcb_get_property_reply(connection, cookie, nullptr);
+        if (!reply) {
+            break;
+        }
+        remaining = 0;
+        if ((reply->type == XCB_ATOM_ATOM) && (reply->format == 32)) {
+            const int len = (xcb_get_property_value_length(reply) / sizeof(xcb_atom_t));
+            const auto atoms = static_cast<const xcb_atom_t *>(xcb_get_property_value(reply));
+            result.reserve(result.size() + len);
+            for (int index = 0; index != len; ++index) {
+                result.insert(atoms[index]);
+            }
+            remaining = reply->bytes_after;
+            offset += len;
+        }
+        std::free(reply);
+    } while (remaining > 0);
+    return result;
+}
+
+[[nodiscard]] static inline X11AtomSet fetchRootWindowProperties()
+{
+    xcb_connection_t * const connection = Utils::x11_connection();
+    Q_ASSERT(connection);
+    if (!connection) {
+        return {};
+    }
+    const quint32 rootWindow = Utils::x11_appRootWindow(Utils::x11_appScreen());
+    Q_ASSERT(rootWindow);
+    if (!rootWindow) {
+        return {};
+    }
+    const xcb_list_properties_cookie_t cookie = xcb_list_properties(connection, rootWindow);
+    xcb_list_properties_reply_t * const reply = xcb_list_properties_reply(connection, cookie, nullptr);
+    if (!reply) {
+        return {};
+    }
+    const int len = xcb_list_properties_atoms_length(reply);
+    const auto atoms = static_cast<const xcb_atom_t *>(xcb_list_properties_atoms(reply));
+    X11AtomSet result = {};
+    result.reserve(len);
+    for (int index = 0; index != len; ++index) {
+        result.insert(atoms[index]);
+    }
+    std::free(reply);
+    return result;
+}
+
 [[maybe_unused]] [[nodiscard]] static inline int
     qtEdgesToWmMoveOrResizeOperation(const Qt::Edges edges)
 {
@@ -467,12 +732,12 @@ bool Utils::setBlurBehindWindowEnabled(const WId windowId, const BlurMode mode,
     if (!windowId) {
         return false;
     }
-    static const xcb_atom_t atom = internAtom(ATOM_KDE_NET_WM_BLUR_BEHIND_REGION);
+    const xcb_atom_t atom = x11Atom(X11Atom::KDE_NET_WM_BLUR_BEHIND_REGION);
     if ((atom == XCB_NONE) || !isSupportedByRootWindow(atom)) {
         WARNING << "Current window manager doesn't support blur behind window.";
         return false;
     }
-    static const xcb_atom_t deepinAtom = internAtom(ATOM_NET_WM_DEEPIN_BLUR_REGION_MASK);
+    const xcb_atom_t deepinAtom = x11Atom(X11Atom::NET_WM_DEEPIN_BLUR_REGION_MASK);
     if ((deepinAtom != XCB_NONE) && isSupportedByWindowManager(deepinAtom)) {
         clearWindowProperty(windowId, deepinAtom);
     }
@@ -561,12 +826,12 @@ bool Utils::isBlurBehindWindowSupported()
         static const QString windowManager = getWindowManagerName();
         static const bool isDeepinV15 = (windowManager == FRAMELESSHELPER_STRING_LITERAL("Mutter(DeepinGala)"));
         if (isDeepinV15) {
-            static const xcb_atom_t atom = internAtom(ATOM_NET_WM_DEEPIN_BLUR_REGION_ROUNDED);
+            const xcb_atom_t atom = x11Atom(X11Atom::NET_WM_DEEPIN_BLUR_REGION_ROUNDED);
             return ((atom != XCB_NONE) && isSupportedByWindowManager(atom));
         }
         static const bool isKWin = (windowManager == FRAMELESSHELPER_STRING_LITERAL("KWin"));
         if (isKWin) {
-            static const xcb_atom_t atom = internAtom(ATOM_KDE_NET_WM_BLUR_BEHIND_REGION);
+            const xcb_atom_t atom = x11Atom(X11Atom::KDE_NET_WM_BLUR_BEHIND_REGION);
             return ((atom != XCB_NONE) && isSupportedByRootWindow(atom));
         }
 #endif
@@ -637,7 +902,7 @@ QString Utils::getWindowManagerName()
         if (!rootWindow) {
             return {};
         }
-        static const xcb_atom_t wmCheckAtom = internAtom(ATOM_NET_SUPPORTING_WM_CHECK);
+        const xcb_atom_t wmCheckAtom = x11Atom(X11Atom::NET_SUPPORTING_WM_CHECK);
         if (wmCheckAtom == XCB_NONE) {
             WARNING << "Failed to retrieve the atom of _NET_SUPPORTING_WM_CHECK.";
             return {};
@@ -656,12 +921,12 @@ QString Utils::getWindowManagerName()
             std::free(reply);
             return {};
         }
-        static const xcb_atom_t wmNameAtom = internAtom(ATOM_NET_WM_NAME);
+        const xcb_atom_t wmNameAtom = x11Atom(X11Atom::NET_WM_NAME);
         if (wmNameAtom == XCB_NONE) {
             WARNING << "Failed to retrieve the atom of _NET_WM_NAME.";
             return {};
         }
-        static const xcb_atom_t strAtom = internAtom(ATOM_UTF8_STRING);
+        const xcb_atom_t strAtom = x11Atom(X11Atom::UTF8_STRING);
         if (strAtom == XCB_NONE) {
             WARNING << "Failed to retrieve the atom of UTF8_STRING.";
             return {};
@@ -706,7 +971,7 @@ void Utils::openSystemMenu(const WId windowId, const QPoint &globalPos)
         return;
     }
 
-    static const xcb_atom_t atom = internAtom(ATOM_GTK_SHOW_WINDOW_MENU);
+    const xcb_atom_t atom = x11Atom(X11Atom::GTK_SHOW_WINDOW_MENU);
     if ((atom == XCB_NONE) || !isSupportedByWindowManager(atom)) {
         WARNING << "Current window manager doesn't support showing window menu.";
         return;
@@ -790,51 +1055,14 @@ bool Utils::isSupportedByWindowManager(const xcb_atom_t atom)
     if (atom == XCB_NONE) {
         return false;
     }
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    using result_type = QList<xcb_atom_t>;
-#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
-    using result_type = QVector<xcb_atom_t>;
-#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    static const auto netWmAtoms = []() -> result_type {
-        xcb_connection_t * const connection = x11_connection();
-        Q_ASSERT(connection);
-        if (!connection) {
-            return {};
-        }
-        const quint32 rootWindow = x11_appRootWindow(x11_appScreen());
-        Q_ASSERT(rootWindow);
-        if (!rootWindow) {
-            return {};
-        }
-        static const xcb_atom_t netSupportedAtom = internAtom(ATOM_NET_SUPPORTED);
-        if (netSupportedAtom == XCB_NONE) {
-            WARNING << "Failed to retrieve the atom of _NET_SUPPORTED.";
-            return {};
-        }
-        result_type result = {};
-        int offset = 0;
-        int remaining = 0;
-        do {
-            const xcb_get_property_cookie_t cookie = xcb_get_property(connection, false, rootWindow, netSupportedAtom, XCB_ATOM_ATOM, offset, 1024);
-            xcb_get_property_reply_t * const reply = xcb_get_property_reply(connection, cookie, nullptr);
-            if (!reply) {
-                break;
-            }
-            remaining = 0;
-            if ((reply->type == XCB_ATOM_ATOM) && (reply->format == 32)) {
-                const int len = (xcb_get_property_value_length(reply) / sizeof(xcb_atom_t));
-                const auto atoms = static_cast<xcb_atom_t *>(xcb_get_property_value(reply));
-                const int size = result.size();
-                result.resize(size + len);
-                std::memcpy(result.data() + size, atoms, len * sizeof(xcb_atom_t));
-                remaining = reply->bytes_after;
-                offset += len;
-            }
-            std::free(reply);
-        } while (remaining > 0);
-        return result;
-    }();
-    return netWmAtoms.contains(atom);
+    // Watch the root window before reading from it, so that no change gets lost.
+    installRootWindowWatcher();
+    X11RootWindowData * const data = g_x11RootWindowData();
+    const QMutexLocker locker(&data->mutex);
+    if (!data->netSupportedAtoms.has_value()) {
+        data->netSupportedAtoms = fetchNetSupportedAtoms();
+    }
+    return data->netSupportedAtoms->contains(atom);
 }
 
 bool Utils::isSupportedByRootWindow(const xcb_atom_t atom)
@@ -843,36 +1071,14 @@ bool Utils::isSupportedByRootWindow(const xcb_atom_t atom)
     if (atom == XCB_NONE) {
         return false;
     }
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    using result_type = QList<xcb_atom_t>;
-#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
-    using result_type = QVector<xcb_atom_t>;
-#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-    static const auto rootWindowProperties = []() -> result_type {
-        xcb_connection_t * const connection = x11_connection();
-        Q_ASSERT(connection);
-        if (!connection) {
-            return {};
-        }
-        const quint32 rootWindow = x11_appRootWindow(x11_appScreen());
-        Q_ASSERT(rootWindow);
-        if (!rootWindow) {
-            return {};
-        }
-        result_type result = {};
-        const xcb_list_properties_cookie_t cookie = xcb_list_properties(connection, rootWindow);
-        xcb_list_properties_reply_t * const reply = xcb_list_properties_reply(connection, cookie, nullptr);
-        if (!reply) {
-            return {};
-        }
-        const int len = xcb_list_properties_atoms_length(reply);
-        const auto atoms = static_cast<xcb_atom_t *>(xcb_list_properties_atoms(reply));
-        result.resize(len);
-        std::memcpy(result.data(), atoms, len * sizeof(xcb_atom_t));
-        std::free(reply);
-        return result;
-    }();
-    return rootWindowProperties.contains(atom);
+    // Watch the root window before reading from it, so that no change gets lost.
+    installRootWindowWatcher();
+    X11RootWindowData * const data = g_x11RootWindowData();
+    const QMutexLocker locker(&data->mutex);
+    if (!data->rootWindowProperties.has_value()) {
+        data->rootWindowProperties = fetchRootWindowProperties();
+    }
+    return data->rootWindowProperties->contains(atom);
 }
 
 bool Utils::tryHideSystemTitleBar(const WId windowId, const bool hide)
@@ -881,14 +1087,14 @@ bool Utils::tryHideSystemTitleBar(const WId windowId, const bool hide)
     if (!windowId) {
         return false;
     }
-    static const xcb_atom_t deepinNoTitleBarAtom = internAtom(ATOM_DEEPIN_NO_TITLEBAR);
+    const xcb_atom_t deepinNoTitleBarAtom = x11Atom(X11Atom::DEEPIN_NO_TITLEBAR);
     if ((deepinNoTitleBarAtom == XCB_NONE) || !isSupportedByWindowManager(deepinNoTitleBarAtom)) {
         WARNING << "Current window manager doesn't support hiding title bar natively.";
         return false;
     }
     const quint32 value = hide;
     setWindowProperty(windowId, deepinNoTitleBarAtom, XCB_ATOM_CARDINAL, &value, 1, sizeof(quint32) * 8);
-    static const xcb_atom_t deepinForceDecorateAtom = internAtom(ATOM_DEEPIN_FORCE_DECORATE);
+    const xcb_atom_t deepinForceDecorateAtom = x11Atom(X11Atom::DEEPIN_FORCE_DECORATE);
     if ((deepinForceDecorateAtom == XCB_NONE) || !isSupportedByWindowManager(deepinForceDecorateAtom)) {
         return true;
     }
@@ -918,7 +1124,7 @@ void Utils::sendMoveResizeMessage(const WId windowId, const uint32_t action, con
         return;
     }
 
-    static const xcb_atom_t atom = internAtom(ATOM_NET_WM_MOVERESIZE);
+    const xcb_atom_t atom = x11Atom(X11Atom::NET_WM_MOVERESIZE);
     if ((atom == XCB_NONE) || !isSupportedByWindowManager(atom)) {
         WARNING << "Current window manager doesn't support move resize operation.";
         return;
@@ -953,7 +1159,7 @@ void Utils::sendMoveResizeMessage(const WId windowId, const uint32_t action, con
 
 bool Utils::isCustomDecorationSupported()
 {
-    static const xcb_atom_t atom = internAtom(ATOM_DEEPIN_NO_TITLEBAR);
+    const xcb_atom_t atom = x11Atom(X11Atom::DEEPIN_NO_TITLEBAR);
     return ((atom != XCB_NONE) && isSupportedByWindowManager(atom));
 }
 
@@ -195,7 +195,7 @@ FRAMELESSHELPER_STRING_CONSTANT(GetCursorPos)
 
 struct Win32UtilsData
 {
-    SystemParameters params = {};
+    FramelessParamsShared params = nullptr;
 };
 
 struct Win32UtilsInternal
@@ -1073,8 +1073,8 @@ static constexpr const std::array<Win32Message, 333> g_win32MessageMap =
     switch (uMsg) {
     case WM_RBUTTONUP: {
         const QPoint nativeLocalPos = getNativePosFromMouse();
-        const QPoint qtScenePos = Utils::fromNativeLocalPosition(data.params.getWindowHandle(), nativeLocalPos);
-        if (data.params.isInsideTitleBarDraggableArea(qtScenePos)) {
+        const QPoint qtScenePos = Utils::fromNativeLocalPosition(data.params->getWindowHandle(), nativeLocalPos);
+        if (data.params->isInsideTitleBarDraggableArea(qtScenePos)) {
             POINT pos = {nativeLocalPos.x(), nativeLocalPos.y()};
             if (::ClientToScreen(hWnd, &pos) == FALSE) {
                 WARNING << Utils::getSystemErrorMessage(kClientToScreen);
@@ -1112,7 +1112,7 @@ static constexpr const std::array<Win32Message, 333> g_win32MessageMap =
         break;
     }
     if (shouldShowSystemMenu) {
-        std::ignore = Utils::showSystemMenu(windowId, nativeGlobalPos, broughtByKeyboard, &data.params);
+        std::ignore = Utils::showSystemMenu(windowId, nativeGlobalPos, broughtByKeyboard, data.params.get());
         // QPA's internal code will handle system menu events separately, and its
         // behavior is not what we would want to see because it doesn't know our
         // window doesn't have any window frame now, so return early here to avoid
@@ -2006,7 +2006,7 @@ bool Utils::isFrameBorderColorized()
     return isTitleBarColorized();
 }
 
-bool Utils::installWindowProcHook(const WId windowId, FramelessParamsConst params)
+bool Utils::installWindowProcHook(const WId windowId, const FramelessParamsShared &params)
 {
     Q_ASSERT(windowId);
     Q_ASSERT(params);
@@ -2027,7 +2027,7 @@ bool Utils::installWindowProcHook(const WId windowId, FramelessParamsConst param
     const auto it = g_win32UtilsData()->data.constFind(windowId);
     if (it == g_win32UtilsData()->data.constEnd()) {
         Win32UtilsData data = {};
-        data.params = *params;
+        data.params = params;
         g_win32UtilsData()->data.insert(windowId, data);
         ::SetLastError(ERROR_SUCCESS);
         if (::SetWindowLongPtrW(hwnd, GWLP_WNDPROC, reinterpret_cast<LONG_PTR>(FramelessHelperHookWindowProc)) == 0) {
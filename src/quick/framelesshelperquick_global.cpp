@@ -107,6 +107,7 @@ void FramelessHelperQuickInitialize()
     REG_META_TYPE(QuickGlobal::ButtonState);
     REG_META_TYPE(QuickGlobal::BlurMode);
     REG_META_TYPE(QuickGlobal::WindowEdge);
+    REG_META_TYPE(QuickGlobal::MicaQuality);
 #endif
 }
 
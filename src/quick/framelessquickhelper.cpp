@@ -34,6 +34,7 @@
 #include <FramelessHelper/Core/utils.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
 #include <FramelessHelper/Core/private/framelesshelpercore_global_p.h>
+#include <FramelessHelper/Core/private/hittestindex_p.h>
 #ifdef Q_OS_WINDOWS
 #  include <FramelessHelper/Core/private/winverhelper_p.h>
 #endif // Q_OS_WINDOWS
@@ -75,7 +76,7 @@ using namespace Global;
 struct FramelessQuickHelperData
 {
     bool ready = false;
-    SystemParameters params = {};
+    FramelessParamsShared params = nullptr;
     QPointer<QQuickItem> titleBarItem = nullptr;
     QList<QPointer<QQuickItem>> hitTestVisibleItems = {};
     QPointer<QQuickItem> windowIconButton = nullptr;
@@ -84,12 +85,111 @@ struct FramelessQuickHelperData
     QPointer<QQuickItem> maximizeButton = nullptr;
     QPointer<QQuickItem> closeButton = nullptr;
     QList<QRect> hitTestVisibleRects = {};
+    // The title bar and everything inside of it that is not draggable, it's only calculated again
+    // after the title bar, the system buttons or the hit test visible items have been changed.
+    std::optional<HitTestIndex> titleBarHitTestIndex = std::nullopt;
+    // Removes the data once the window is gone, there's only one per window.
+    QMetaObject::Connection destroyedConnection = {};
 };
 
-using FramelessQuickHelperInternal = QHash<WId, FramelessQuickHelperData>;
+// Shared by all the helpers of the same window, each of them remembers the data of its window,
+// so the hash is only consulted when a helper looks up its window for the first time.
+// Keyed by the window itself, unlike winId() it never creates the native window.
+using FramelessQuickHelperInternal = QHash<const QQuickWindow *, std::shared_ptr<FramelessQuickHelperData>>;
 
 Q_GLOBAL_STATIC(FramelessQuickHelperInternal, g_framelessQuickHelperData)
 
+class FramelessQuickSystemParameters final : public SystemParameters
+{
+public:
+    explicit FramelessQuickSystemParameters(FramelessQuickHelperPrivate *d, QQuickWindow *window) : d(d), window(window)
+    {
+        Q_ASSERT(d);
+        Q_ASSERT(window);
+    }
+    ~FramelessQuickSystemParameters() override = default;
+
+    Qt::WindowFlags getWindowFlags() const override { return window->flags(); }
+    void setWindowFlags(const Qt::WindowFlags flags) const override { window->setFlags(flags); }
+    QSize getWindowSize() const override { return window->size(); }
+    void setWindowSize(const QSize &size) const override { window->resize(size); }
+    QPoint getWindowPosition() const override { return window->position(); }
+    void setWindowPosition(const QPoint &pos) const override { window->setX(pos.x()); window->setY(pos.y()); }
+    QScreen *getWindowScreen() const override { return window->screen(); }
+    bool isWindowFixedSize() const override { return d->q_ptr->isWindowFixedSize(); }
+    void setWindowFixedSize(const bool value) const override { d->q_ptr->setWindowFixedSize(value); }
+    Qt::WindowState getWindowState() const override { return window->windowState(); }
+    void setWindowState(const Qt::WindowState state) const override { window->setWindowState(state); }
+    QWindow *getWindowHandle() const override { return window; }
+    QPoint windowToScreen(const QPoint &pos) const override { return window->mapToGlobal(pos); }
+    QPoint screenToWindow(const QPoint &pos) const override { return window->mapFromGlobal(pos); }
+    bool isInsideSystemButtons(const QPoint &pos, SystemButtonType *button) const override
+    {
+        QuickGlobal::SystemButtonType button2 = QuickGlobal::SystemButtonType::Unknown;
+        const bool result = d->isInSystemButtons(pos, &button2);
+        *button = FRAMELESSHELPER_ENUM_QUICK_TO_CORE(SystemButtonType, button2);
+        return result;
+    }
+    bool isInsideTitleBarDraggableArea(const QPoint &pos) const override { return d->isInTitleBarDraggableArea(pos); }
+    qreal getWindowDevicePixelRatio() const override { return window->effectiveDevicePixelRatio(); }
+    void setSystemButtonState(const SystemButtonType button, const ButtonState state) const override
+    {
+        d->setSystemButtonState(FRAMELESSHELPER_ENUM_CORE_TO_QUICK(SystemButtonType, button),
+                                FRAMELESSHELPER_ENUM_CORE_TO_QUICK(ButtonState, state));
+    }
+    WId getWindowId() const override { return window->winId(); }
+    bool shouldIgnoreMouseEvents(const QPoint &pos) const override { return d->shouldIgnoreMouseEvents(pos); }
+    void showSystemMenu(const QPoint &pos) const override { d->q_ptr->showSystemMenu(pos); }
+    void setProperty(const char *name, const QVariant &value) const override { d->setProperty(name, value); }
+    QVariant getProperty(const char *name, const QVariant &defaultValue) const override { return d->getProperty(name, defaultValue); }
+    void setCursor(const QCursor &cursor) const override { window->setCursor(cursor); }
+    void unsetCursor() const override { window->unsetCursor(); }
+    QObject *getWidgetHandle() const override { return nullptr; }
+    void forceChildrenRepaint(const int delay) const override { d->repaintAllChildren(delay); }
+    bool resetQtGrabbedControl() const override { return false; }
+    HitTestResult hitTest(const QPoint &pos, const bool querySystemButton) const override { return d->hitTest(pos, querySystemButton); }
+
+private:
+    FramelessQuickHelperPrivate * const d = nullptr;
+    QQuickWindow * const window = nullptr;
+};
+
+static inline void updateVisibleItems(const QQuickWindow * const window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    QQuickItem * const rootItem = window->contentItem();
+    if (!rootItem) {
+        return;
+    }
+    const QRectF windowRect = { QPointF(0, 0), QSizeF(window->size()) };
+    // Walk the visual item tree instead of the QObject tree, so that whole
+    // subtrees can be skipped when they can't be seen anyway.
+    QList<QQuickItem *> items = { rootItem };
+    while (!items.isEmpty()) {
+        QQuickItem * const item = items.takeLast();
+        // Hidden or fully transparent items hide their children as well.
+        if (!item->isVisible() || qFuzzyIsNull(item->opacity())) {
+            continue;
+        }
+        const bool hasContents = (item->flags() & QQuickItem::ItemHasContents);
+        if (hasContents || item->clip()) {
+            const bool onScreen = item->mapRectToScene(item->boundingRect()).intersects(windowRect);
+            // Nothing inside an off screen item that clips its children can be seen.
+            if (!onScreen && item->clip()) {
+                continue;
+            }
+            // Only items with the "QQuickItem::ItemHasContents" flag enabled are allowed to call "update()".
+            if (onScreen && hasContents) {
+                item->update();
+            }
+        }
+        items.append(item->childItems());
+    }
+}
+
 FramelessQuickHelperPrivate::FramelessQuickHelperPrivate(FramelessQuickHelper *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -135,45 +235,9 @@ void FramelessQuickHelperPrivate::attach()
         return;
     }
 
-    SystemParameters params = {};
-    params.getWindowId = [window]() -> WId { return window->winId(); };
-    params.getWindowFlags = [window]() -> Qt::WindowFlags { return window->flags(); };
-    params.setWindowFlags = [window](const Qt::WindowFlags flags) -> void { window->setFlags(flags); };
-    params.getWindowSize = [window]() -> QSize { return window->size(); };
-    params.setWindowSize = [window](const QSize &size) -> void { window->resize(size); };
-    params.getWindowPosition = [window]() -> QPoint { return window->position(); };
-    params.setWindowPosition = [window](const QPoint &pos) -> void { window->setX(pos.x()); window->setY(pos.y()); };
-    params.getWindowScreen = [window]() -> QScreen * { return window->screen(); };
-    params.isWindowFixedSize = [q]() -> bool { return q->isWindowFixedSize(); };
-    params.setWindowFixedSize = [q](const bool value) -> void { q->setWindowFixedSize(value); };
-    params.getWindowState = [window]() -> Qt::WindowState { return window->windowState(); };
-    params.setWindowState = [window](const Qt::WindowState state) -> void { window->setWindowState(state); };
-    params.getWindowHandle = [window]() -> QWindow * { return window; };
-    params.windowToScreen = [window](const QPoint &pos) -> QPoint { return window->mapToGlobal(pos); };
-    params.screenToWindow = [window](const QPoint &pos) -> QPoint { return window->mapFromGlobal(pos); };
-    params.isInsideSystemButtons = [this](const QPoint &pos, SystemButtonType *button) -> bool {
-        QuickGlobal::SystemButtonType button2 = QuickGlobal::SystemButtonType::Unknown;
-        const bool result = isInSystemButtons(pos, &button2);
-        *button = FRAMELESSHELPER_ENUM_QUICK_TO_CORE(SystemButtonType, button2);
-        return result;
-    };
-    params.isInsideTitleBarDraggableArea = [this](const QPoint &pos) -> bool { return isInTitleBarDraggableArea(pos); };
-    params.getWindowDevicePixelRatio = [window]() -> qreal { return window->effectiveDevicePixelRatio(); };
-    params.setSystemButtonState = [this](const SystemButtonType button, const ButtonState state) -> void {
-        setSystemButtonState(FRAMELESSHELPER_ENUM_CORE_TO_QUICK(SystemButtonType, button),
-                             FRAMELESSHELPER_ENUM_CORE_TO_QUICK(ButtonState, state));
-    };
-    params.shouldIgnoreMouseEvents = [this](const QPoint &pos) -> bool { return shouldIgnoreMouseEvents(pos); };
-    params.showSystemMenu = [q](const QPoint &pos) -> void { q->showSystemMenu(pos); };
-    params.setProperty = [this](const char *name, const QVariant &value) -> void { setProperty(name, value); };
-    params.getProperty = [this](const char *name, const QVariant &defaultValue) -> QVariant { return getProperty(name, defaultValue); };
-    params.setCursor = [window](const QCursor &cursor) -> void { window->setCursor(cursor); };
-    params.unsetCursor = [window]() -> void { window->unsetCursor(); };
-    params.getWidgetHandle = []() -> QObject * { return nullptr; };
-    params.forceChildrenRepaint = [this](const int delay) -> void { repaintAllChildren(delay); };
-    params.resetQtGrabbedControl = []() -> bool { return false; };
-
-    FramelessManager::instance()->addWindow(&params);
+    const auto params = std::make_shared<FramelessQuickSystemParameters>(this, window);
+
+    FramelessManager::instance()->addWindow(params);
 
     data->params = params;
     data->ready = true;
@@ -202,13 +266,19 @@ void FramelessQuickHelperPrivate::detach()
     if (!w) {
         return;
     }
-    const WId windowId = w->winId();
-    const auto it = g_framelessQuickHelperData()->constFind(windowId);
+    const auto it = g_framelessQuickHelperData()->constFind(w);
     if (it == g_framelessQuickHelperData()->constEnd()) {
         return;
     }
+    disconnect(it.value()->destroyedConnection);
     g_framelessQuickHelperData()->erase(it);
-    FramelessManager::instance()->removeWindow(windowId);
+    // winId() would create a native window just to remove it again.
+    if (w->handle()) {
+        FramelessManager::instance()->removeWindow(w->winId());
+    }
+    cancelPendingRepaint();
+    windowData.reset();
+    windowDataOwner = nullptr;
 }
 
 void FramelessQuickHelperPrivate::emitSignalForAllInstances(const char *signal)
@@ -369,7 +439,7 @@ void FramelessQuickHelperPrivate::repaintAllChildren(const quint32 delay) const
     if (!window) {
         return;
     }
-    const auto update = [window]() -> void {
+    const auto update = [this, window]() -> void {
 #ifdef Q_OS_WINDOWS
         // Sync the internal window frame margins with the latest DPI, otherwise
         // we will get wrong window sizes after the DPI change.
@@ -379,18 +449,24 @@ void FramelessQuickHelperPrivate::repaintAllChildren(const quint32 delay) const
         if (!window->isVisible()) {
             return;
         }
-        window->requestUpdate();
-        const QList<QQuickItem *> items = window->findChildren<QQuickItem *>();
-        if (items.isEmpty()) {
+        // No frame will be rendered while the window is not exposed (minimized
+        // for example), so there's nothing to wait for.
+        if (!window->isExposed()) {
+            cancelPendingRepaint();
+            updateVisibleItems(window);
             return;
         }
-        for (auto &&item : std::as_const(items)) {
-            // Only items with the "QQuickItem::ItemHasContents" flag enabled are allowed to call "update()".
-            // And don't repaint the item if it's hidden.
-            if ((item->flags() & QQuickItem::ItemHasContents) && item->isVisible()) {
-                item->update();
-            }
+        // Already scheduled for the next frame.
+        if (repaintConnection) {
+            return;
         }
+        // Update the items right before the next frame is synchronized with the
+        // scene graph, so that all of them are handled together in that frame.
+        repaintConnection = connect(window, &QQuickWindow::afterAnimating, this, [this, window]() -> void {
+            cancelPendingRepaint();
+            updateVisibleItems(window);
+        });
+        window->requestUpdate();
     };
     if (delay > 0) {
         QTimer::singleShot(delay, this, update);
@@ -399,6 +475,15 @@ void FramelessQuickHelperPrivate::repaintAllChildren(const quint32 delay) const
     }
 }
 
+void FramelessQuickHelperPrivate::cancelPendingRepaint() const
+{
+    if (!repaintConnection) {
+        return;
+    }
+    disconnect(repaintConnection);
+    repaintConnection = {};
+}
+
 quint32 FramelessQuickHelperPrivate::readyWaitTime() const
 {
     return qpaWaitTime;
@@ -428,12 +513,16 @@ QRect FramelessQuickHelperPrivate::mapItemGeometryToScene(const QQuickItem * con
 }
 
 bool FramelessQuickHelperPrivate::isInSystemButtons(const QPoint &pos, QuickGlobal::SystemButtonType *button) const
+{
+    return isInSystemButtons(getWindowData(), pos, button);
+}
+
+bool FramelessQuickHelperPrivate::isInSystemButtons(const FramelessQuickHelperData *data, const QPoint &pos, QuickGlobal::SystemButtonType *button) const
 {
     Q_ASSERT(button);
     if (!button) {
         return false;
     }
-    const FramelessQuickHelperData *data = getWindowData();
     if (!data) {
         return false;
     }
@@ -473,33 +562,49 @@ bool FramelessQuickHelperPrivate::isInSystemButtons(const QPoint &pos, QuickGlob
 
 bool FramelessQuickHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos) const
 {
-    const FramelessQuickHelperData *data = getWindowData();
+    return isInTitleBarDraggableArea(getWindowDataMutable(), pos);
+}
+
+bool FramelessQuickHelperPrivate::isInTitleBarDraggableArea(FramelessQuickHelperData *data, const QPoint &pos) const
+{
     if (!data) {
         return false;
     }
+    if (!data->titleBarHitTestIndex.has_value()) {
+        data->titleBarHitTestIndex = calculateTitleBarHitTestIndex();
+    }
+    return data->titleBarHitTestIndex.value().isInFreeArea(pos);
+}
+
+HitTestIndex FramelessQuickHelperPrivate::calculateTitleBarHitTestIndex() const
+{
+    const FramelessQuickHelperData *data = getWindowData();
+    if (!data) {
+        return {};
+    }
     if (!data->titleBarItem) {
         // There's no title bar at all, the mouse will always be in the client area.
-        return false;
+        return {};
     }
     if (!data->titleBarItem->isVisible() || !data->titleBarItem->isEnabled()) {
         // The title bar is hidden or disabled for some reason, treat it as there's no title bar.
-        return false;
+        return {};
     }
     Q_Q(const FramelessQuickHelper);
     const QQuickWindow * const window = q->window();
     if (!window) {
         // The FramelessQuickHelper item has not been attached to a specific window yet,
         // so we assume there's no title bar.
-        return false;
+        return {};
     }
     const QRect windowRect = {QPoint(0, 0), window->size()};
     const QRect titleBarRect = mapItemGeometryToScene(data->titleBarItem);
     if (!titleBarRect.intersects(windowRect)) {
         // The title bar is totally outside of the window for some reason,
         // also treat it as there's no title bar.
-        return false;
+        return {};
     }
-    QRegion region = titleBarRect;
+    QList<QRect> rects = {};
     const auto systemButtons = {
         data->windowIconButton, data->contextHelpButton,
         data->minimizeButton, data->maximizeButton,
@@ -507,24 +612,78 @@ bool FramelessQuickHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos) c
     };
     for (auto &&button : std::as_const(systemButtons)) {
         if (button && button->isVisible() && button->isEnabled()) {
-            region -= mapItemGeometryToScene(button);
+            rects.append(mapItemGeometryToScene(button));
         }
     }
     if (!data->hitTestVisibleItems.isEmpty()) {
         for (auto &&item : std::as_const(data->hitTestVisibleItems)) {
             if (item && item->isVisible() && item->isEnabled()) {
-                region -= mapItemGeometryToScene(item);
+                rects.append(mapItemGeometryToScene(item));
             }
         }
     }
     if (!data->hitTestVisibleRects.isEmpty()) {
         for (auto &&rect : std::as_const(data->hitTestVisibleRects)) {
             if (rect.isValid()) {
-                region -= rect;
+                rects.append(rect);
             }
         }
     }
-    return region.contains(pos);
+    return HitTestIndex(titleBarRect, rects);
+}
+
+void FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex()
+{
+    Q_Q(const FramelessQuickHelper);
+    const QQuickWindow * const window = q->window();
+    if (window && (windowDataOwner == window)) {
+        if (const std::shared_ptr<FramelessQuickHelperData> data = windowData.lock()) {
+            data->titleBarHitTestIndex = std::nullopt;
+            return;
+        }
+    }
+    // This may be called while the window is being destroyed, so don't create the window data here.
+    if (!window) {
+        return;
+    }
+    const auto it = g_framelessQuickHelperData()->find(window);
+    if (it == g_framelessQuickHelperData()->end()) {
+        return;
+    }
+    it.value()->titleBarHitTestIndex = std::nullopt;
+}
+
+void FramelessQuickHelperPrivate::watchHitTestItem(QQuickItem *item)
+{
+    Q_ASSERT(item);
+    if (!item) {
+        return;
+    }
+    // The position of an item inside the window also changes when any of its
+    // parents moves, so the whole parent chain has to be watched.
+    for (QQuickItem *i = item; i; i = i->parentItem()) {
+        static constexpr const auto type = Qt::UniqueConnection;
+        connect(i, &QQuickItem::xChanged, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::yChanged, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::widthChanged, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::heightChanged, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::scaleChanged, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::rotationChanged, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::transformOriginChanged, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::visibleChanged, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::enabledChanged, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::destroyed, this, &FramelessQuickHelperPrivate::invalidateTitleBarHitTestIndex, type);
+        connect(i, &QQuickItem::parentChanged, this, &FramelessQuickHelperPrivate::handleHitTestItemParentChanged, type);
+    }
+    invalidateTitleBarHitTestIndex();
+}
+
+void FramelessQuickHelperPrivate::handleHitTestItemParentChanged()
+{
+    // The item has been moved to another parent, the new parent chain needs to be watched as well.
+    if (const auto item = qobject_cast<QQuickItem *>(sender())) {
+        watchHitTestItem(item);
+    }
 }
 
 bool FramelessQuickHelperPrivate::shouldIgnoreMouseEvents(const QPoint &pos) const
@@ -549,6 +708,32 @@ bool FramelessQuickHelperPrivate::shouldIgnoreMouseEvents(const QPoint &pos) con
     return ((window->visibility() == QQuickWindow::Windowed) && withinFrameBorder);
 }
 
+HitTestResult FramelessQuickHelperPrivate::hitTest(const QPoint &pos, const bool querySystemButton) const
+{
+    HitTestResult result = {};
+    Q_Q(const FramelessQuickHelper);
+    const QQuickWindow * const window = q->window();
+    if (!window) {
+        return result;
+    }
+    // Look up the window data only once for everything.
+    FramelessQuickHelperData * const data = getWindowDataMutable();
+    result.windowEdges = Utils::calculateWindowEdges(window, pos);
+    result.cursorShape = Utils::calculateCursorShape(window, pos);
+    if (querySystemButton) {
+        QuickGlobal::SystemButtonType button = QuickGlobal::SystemButtonType::Unknown;
+        if (isInSystemButtons(data, pos, &button)) {
+            result.systemButton = FRAMELESSHELPER_ENUM_QUICK_TO_CORE(SystemButtonType, button);
+        }
+    }
+    result.insideTitleBarDraggableArea = isInTitleBarDraggableArea(data, pos);
+    result.shouldIgnoreMouseEvents = shouldIgnoreMouseEvents(pos);
+    result.windowFixedSize = q->isWindowFixedSize();
+    result.dontOverrideCursor = window->property(kDontOverrideCursorVar).toBool();
+    result.dontToggleMaximize = window->property(kDontToggleMaximizeVar).toBool();
+    return result;
+}
+
 void FramelessQuickHelperPrivate::setSystemButtonState(const QuickGlobal::SystemButtonType button,
                                                        const QuickGlobal::ButtonState state)
 {
@@ -558,18 +743,7 @@ void FramelessQuickHelperPrivate::setSystemButtonState(const QuickGlobal::System
 
 const FramelessQuickHelperData *FramelessQuickHelperPrivate::getWindowData() const
 {
-    Q_Q(const FramelessQuickHelper);
-    const QQuickWindow * const window = q->window();
-    //Q_ASSERT(window);
-    if (!window) {
-        return nullptr;
-    }
-    const WId windowId = window->winId();
-    auto it = g_framelessQuickHelperData()->find(windowId);
-    if (it == g_framelessQuickHelperData()->end()) {
-        it = g_framelessQuickHelperData()->insert(windowId, {});
-    }
-    return &it.value();
+    return getWindowDataMutable();
 }
 
 FramelessQuickHelperData *FramelessQuickHelperPrivate::getWindowDataMutable() const
@@ -580,12 +754,24 @@ FramelessQuickHelperData *FramelessQuickHelperPrivate::getWindowDataMutable() co
     if (!window) {
         return nullptr;
     }
-    const WId windowId = window->winId();
-    auto it = g_framelessQuickHelperData()->find(windowId);
-    if (it == g_framelessQuickHelperData()->end()) {
-        it = g_framelessQuickHelperData()->insert(windowId, {});
+    // The registry keeps the data alive, unless another helper of the
+    // same window has detached it in the mean time.
+    if (windowDataOwner == window) {
+        if (const std::shared_ptr<FramelessQuickHelperData> data = windowData.lock()) {
+            return data.get();
+        }
     }
-    return &it.value();
+    auto it = g_framelessQuickHelperData()->find(window);
+    if (it == g_framelessQuickHelperData()->end()) {
+        it = g_framelessQuickHelperData()->insert(window, std::make_shared<FramelessQuickHelperData>());
+        // Don't let a new window at the same address inherit the data.
+        it.value()->destroyedConnection = connect(window, &QQuickWindow::destroyed, FramelessManager::instance(), [window](){
+            g_framelessQuickHelperData()->remove(window);
+        });
+    }
+    windowData = it.value();
+    windowDataOwner = window;
+    return it.value().get();
 }
 
 void FramelessQuickHelperPrivate::rebindWindow()
@@ -675,8 +861,10 @@ void FramelessQuickHelper::setHitTestVisible_item(QQuickItem *item, const bool v
     }
     if (visible) {
         data->hitTestVisibleItems.append(item);
+        d->watchHitTestItem(item);
     } else {
         data->hitTestVisibleItems.removeAll(item);
+        d->invalidateTitleBarHitTestIndex();
     }
 }
 
@@ -696,6 +884,7 @@ void FramelessQuickHelper::setHitTestVisible_rect(const QRect &rect, const bool
     } else {
         data->hitTestVisibleRects.removeAll(rect);
     }
+    d->invalidateTitleBarHitTestIndex();
 }
 
 void FramelessQuickHelper::setHitTestVisible_object(QObject *object, const bool visible)
@@ -753,6 +942,7 @@ void FramelessQuickHelper::setTitleBarItem(QQuickItem *value)
         return;
     }
     data->titleBarItem = value;
+    d->watchHitTestItem(value);
     d->emitSignalForAllInstances("titleBarItemChanged");
 }
 
@@ -788,6 +978,7 @@ void FramelessQuickHelper::setSystemButton(QQuickItem *item, const QuickGlobal::
     case QuickGlobal::SystemButtonType::Unknown:
         Q_UNREACHABLE();
     }
+    d->watchHitTestItem(item);
 }
 
 void FramelessQuickHelper::showSystemMenu(const QPoint &pos)
@@ -800,7 +991,11 @@ void FramelessQuickHelper::showSystemMenu(const QPoint &pos)
     const QPoint nativePos = Utils::toNativeGlobalPosition(w, pos);
 #ifdef Q_OS_WINDOWS
     Q_D(FramelessQuickHelper);
-    std::ignore = Utils::showSystemMenu(windowId, nativePos, false, &d->getWindowData()->params);
+    const FramelessQuickHelperData * const data = d->getWindowData();
+    if (!data || !data->params) {
+        return;
+    }
+    std::ignore = Utils::showSystemMenu(windowId, nativePos, false, data->params.get());
 #elif (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
     Utils::openSystemMenu(windowId, nativePos);
 #else
@@ -836,7 +1031,11 @@ void FramelessQuickHelper::moveWindowToDesktopCenter()
         return;
     }
     Q_D(FramelessQuickHelper);
-    Utils::moveWindowToDesktopCenter(&d->getWindowData()->params, true);
+    const FramelessQuickHelperData * const data = d->getWindowData();
+    if (!data || !data->params) {
+        return;
+    }
+    Utils::moveWindowToDesktopCenter(data->params.get(), true);
 }
 
 void FramelessQuickHelper::bringWindowToFront()
@@ -977,9 +1176,13 @@ void FramelessQuickHelper::waitForReady()
 void FramelessQuickHelper::itemChange(const ItemChange change, const ItemChangeData &value)
 {
     QQuickItem::itemChange(change, value);
-    if ((change == ItemSceneChange) && value.window) {
+    if (change == ItemSceneChange) {
         Q_D(FramelessQuickHelper);
-        d->rebindWindow();
+        // A repaint scheduled for the previous window would never be delivered.
+        d->cancelPendingRepaint();
+        if (value.window) {
+            d->rebindWindow();
+        }
     }
 }
 
@@ -110,6 +110,7 @@ void QuickMicaMaterialPrivate::initialize()
     connect(micaMaterial, &MicaMaterial::fallbackColorChanged, q, &QuickMicaMaterial::fallbackColorChanged);
     connect(micaMaterial, &MicaMaterial::noiseOpacityChanged, q, &QuickMicaMaterial::noiseOpacityChanged);
     connect(micaMaterial, &MicaMaterial::fallbackEnabledChanged, q, &QuickMicaMaterial::fallbackEnabledChanged);
+    connect(micaMaterial, &MicaMaterial::qualityChanged, q, &QuickMicaMaterial::qualityChanged);
     connect(micaMaterial, &MicaMaterial::shouldRedraw, q, [q](){ q->update(); });
 }
 
@@ -228,6 +229,18 @@ void QuickMicaMaterial::setFallbackEnabled(const bool value)
     d->micaMaterial->setFallbackEnabled(value);
 }
 
+QuickGlobal::MicaQuality QuickMicaMaterial::quality() const
+{
+    Q_D(const QuickMicaMaterial);
+    return FRAMELESSHELPER_ENUM_CORE_TO_QUICK(MicaQuality, d->micaMaterial->quality());
+}
+
+void QuickMicaMaterial::setQuality(const QuickGlobal::MicaQuality value)
+{
+    Q_D(QuickMicaMaterial);
+    d->micaMaterial->setQuality(FRAMELESSHELPER_ENUM_QUICK_TO_CORE(MicaQuality, value));
+}
+
 void QuickMicaMaterial::itemChange(const ItemChange change, const ItemChangeData &value)
 {
     QQuickPaintedItem::itemChange(change, value);
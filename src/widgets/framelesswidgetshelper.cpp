@@ -37,9 +37,12 @@
 #include <FramelessHelper/Core/utils.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
 #include <FramelessHelper/Core/private/framelesshelpercore_global_p.h>
+#include <FramelessHelper/Core/private/hittestindex_p.h>
+#include <FramelessHelper/Core/private/scopeguard_p.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qtimer.h>
 #include <QtCore/qeventloop.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qwindow.h>
 #include <QtGui/qpalette.h>
@@ -47,6 +50,7 @@
 #include <QtGui/qevent.h>
 #include <QtWidgets/qwidget.h>
 #include <QtWidgets/qapplication.h>
+#include <optional>
 
 #ifndef QWIDGETSIZE_MAX
 #  define QWIDGETSIZE_MAX ((1 << 24) - 1)
@@ -74,7 +78,7 @@ using namespace Global;
 struct FramelessWidgetsHelperData
 {
     bool ready = false;
-    SystemParameters params = {};
+    FramelessParamsShared params = nullptr;
     QPointer<QWidget> titleBarWidget = nullptr;
     QList<QPointer<QWidget>> hitTestVisibleWidgets = {};
     QPointer<QWidget> windowIconButton = nullptr;
@@ -83,12 +87,97 @@ struct FramelessWidgetsHelperData
     QPointer<QWidget> maximizeButton = nullptr;
     QPointer<QWidget> closeButton = nullptr;
     QList<QRect> hitTestVisibleRects = {};
+    // The title bar and everything inside of it that is not draggable, it's only calculated again
+    // after the title bar, the system buttons or the hit test visible widgets have been changed.
+    std::optional<HitTestIndex> titleBarHitTestIndex = std::nullopt;
+    // Removes the data once the window is gone, there's only one per window.
+    QMetaObject::Connection destroyedConnection = {};
+    // The device pixel ratio of each native child widget when it was last repainted.
+    QHash<const QWidget *, qreal> nativeChildDevicePixelRatios = {};
 };
 
-using FramelessWidgetsHelperInternal = QHash<WId, FramelessWidgetsHelperData>;
+// Shared by all the helpers of the same window, each of them remembers the data of its window,
+// so the hash is only consulted when a helper looks up its window for the first time.
+// Keyed by the top level widget itself, unlike winId() it never creates the native window.
+using FramelessWidgetsHelperInternal = QHash<const QWidget *, std::shared_ptr<FramelessWidgetsHelperData>>;
 
 Q_GLOBAL_STATIC(FramelessWidgetsHelperInternal, g_framelessWidgetsHelperData)
 
+// Windows attached through FramelessWidgetsHelper::get(QList) wait for one shared timer.
+struct FramelessWidgetsHelperBatch
+{
+    quint32 waitTime = 0;
+    QList<QPointer<FramelessWidgetsHelper>> helpers = {};
+};
+
+// The batch that is being attached right now, it lives on the stack of findOrCreateFramelessHelpers().
+// Widgets only live in the GUI thread, so does this.
+static FramelessWidgetsHelperBatch *g_currentFramelessWidgetsHelperBatch = nullptr;
+
+class FramelessWidgetsSystemParameters final : public SystemParameters
+{
+public:
+    explicit FramelessWidgetsSystemParameters(FramelessWidgetsHelperPrivate *d) : d(d) { Q_ASSERT(d); }
+    ~FramelessWidgetsSystemParameters() override = default;
+
+    Qt::WindowFlags getWindowFlags() const override { return d->window->windowFlags(); }
+    void setWindowFlags(const Qt::WindowFlags flags) const override { d->window->setWindowFlags(flags); }
+    QSize getWindowSize() const override { return d->window->size(); }
+    void setWindowSize(const QSize &size) const override { d->window->resize(size); }
+    QPoint getWindowPosition() const override { return d->window->pos(); }
+    void setWindowPosition(const QPoint &pos) const override { d->window->move(pos); }
+    QScreen *getWindowScreen() const override
+    {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
+        return d->window->screen();
+#else
+        return d->window->windowHandle()->screen();
+#endif
+    }
+    bool isWindowFixedSize() const override { return d->q_ptr->isWindowFixedSize(); }
+    void setWindowFixedSize(const bool value) const override { d->q_ptr->setWindowFixedSize(value); }
+    Qt::WindowState getWindowState() const override { return Utils::windowStatesToWindowState(d->window->windowState()); }
+    void setWindowState(const Qt::WindowState state) const override { d->window->setWindowState(state); }
+    QWindow *getWindowHandle() const override { return d->window->windowHandle(); }
+    QPoint windowToScreen(const QPoint &pos) const override { return d->window->mapToGlobal(pos); }
+    QPoint screenToWindow(const QPoint &pos) const override { return d->window->mapFromGlobal(pos); }
+    bool isInsideSystemButtons(const QPoint &pos, SystemButtonType *button) const override { return d->isInSystemButtons(pos, button); }
+    bool isInsideTitleBarDraggableArea(const QPoint &pos) const override { return d->isInTitleBarDraggableArea(pos); }
+    qreal getWindowDevicePixelRatio() const override { return d->window->devicePixelRatioF(); }
+    void setSystemButtonState(const SystemButtonType button, const ButtonState state) const override { d->setSystemButtonState(button, state); }
+    WId getWindowId() const override { return d->window->winId(); }
+    bool shouldIgnoreMouseEvents(const QPoint &pos) const override { return d->shouldIgnoreMouseEvents(pos); }
+    void showSystemMenu(const QPoint &pos) const override { d->q_ptr->showSystemMenu(pos); }
+    void setProperty(const char *name, const QVariant &value) const override { d->setProperty(name, value); }
+    QVariant getProperty(const char *name, const QVariant &defaultValue) const override { return d->getProperty(name, defaultValue); }
+    void setCursor(const QCursor &cursor) const override { d->window->setCursor(cursor); }
+    void unsetCursor() const override { d->window->unsetCursor(); }
+    QObject *getWidgetHandle() const override { return d->window; }
+    void forceChildrenRepaint(const int delay) const override { d->repaintAllChildren(delay); }
+    bool resetQtGrabbedControl() const override
+    {
+        if (qt_button_down) {
+            static constexpr const auto invalidPos = QPoint{ -99999, -99999 };
+            const auto event = std::make_unique<QMouseEvent>(
+                QEvent::MouseButtonRelease,
+                invalidPos,
+                invalidPos,
+                invalidPos,
+                Qt::LeftButton,
+                QGuiApplication::mouseButtons() ^ Qt::LeftButton,
+                QGuiApplication::keyboardModifiers());
+            QApplication::sendEvent(qt_button_down, event.get());
+            qt_button_down = nullptr;
+            return true;
+        }
+        return false;
+    }
+    HitTestResult hitTest(const QPoint &pos, const bool querySystemButton) const override { return d->hitTest(pos, querySystemButton); }
+
+private:
+    FramelessWidgetsHelperPrivate * const d = nullptr;
+};
+
 [[nodiscard]] static inline bool isWidgetFixedSize(const QWidget * const widget)
 {
     Q_ASSERT(widget);
@@ -163,6 +252,49 @@ static inline void forceWidgetRepaint(QWidget * const widget)
     // do we need to refresh the font settings here as well?
 }
 
+// Returns how many widgets have been asked to repaint.
+static inline int repaintWidgetTree(QWidget * const window, QHash<const QWidget *, qreal> &devicePixelRatios)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return 0;
+    }
+#ifdef Q_OS_WINDOWS
+    // Same as forceWidgetRepaint(), the frame margins depend on the DPI.
+    if (QWindow * const windowHandle = window->windowHandle()) {
+        std::ignore = Utils::updateInternalWindowFrameMargins(windowHandle, true);
+    }
+#endif // Q_OS_WINDOWS
+    if (!window->isVisible()) {
+        return 0;
+    }
+    // Repainting the whole top level window invalidates its backing store, which repaints
+    // all the alien child widgets as well. Only the child widgets that have their own native
+    // window (and thus their own surface with its own DPR) need to be told separately, and
+    // only if their DPR is not the same as last time. The ones we haven't seen before are
+    // always repainted, we don't know what they looked like.
+    window->update();
+    int count = 1;
+    QHash<const QWidget *, qreal> currentDevicePixelRatios = {};
+    const QList<QWidget *> widgets = window->findChildren<QWidget *>();
+    for (auto &&widget : std::as_const(widgets)) {
+        if (!widget->internalWinId() || !widget->isVisible()) {
+            continue;
+        }
+        const qreal dpr = widget->devicePixelRatioF();
+        currentDevicePixelRatios.insert(widget, dpr);
+        const auto it = devicePixelRatios.constFind(widget);
+        if ((it != devicePixelRatios.constEnd()) && qFuzzyCompare(it.value(), dpr)) {
+            continue;
+        }
+        widget->update();
+        ++count;
+    }
+    // Forget the widgets that are gone, so that their addresses can't be mistaken for new ones.
+    devicePixelRatios = std::move(currentDevicePixelRatios);
+    return count;
+}
+
 FramelessWidgetsHelperPrivate::FramelessWidgetsHelperPrivate(FramelessWidgetsHelper *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -323,20 +455,71 @@ FramelessWidgetsHelper *FramelessWidgetsHelperPrivate::findOrCreateFramelessHelp
     return instance;
 }
 
+QList<FramelessWidgetsHelper *> FramelessWidgetsHelperPrivate::findOrCreateFramelessHelpers(const QList<QWidget *> &windows)
+{
+    if (windows.isEmpty()) {
+        return {};
+    }
+    QList<FramelessWidgetsHelper *> helpers = {};
+    helpers.reserve(windows.size());
+    const auto attachAll = [&windows, &helpers](){
+        for (auto &&window : std::as_const(windows)) {
+            helpers.append(window ? findOrCreateFramelessHelper(window) : nullptr);
+        }
+    };
+    // A batch started while another one is being attached (from a slot connected
+    // to one of the signals emitted in the mean time) simply joins it.
+    if (g_currentFramelessWidgetsHelperBatch) {
+        attachAll();
+        return helpers;
+    }
+    QElapsedTimer timer = {};
+    timer.start();
+    FramelessWidgetsHelperBatch batch = {};
+    {
+        g_currentFramelessWidgetsHelperBatch = &batch;
+        const auto batchGuard = qScopeGuard([](){ g_currentFramelessWidgetsHelperBatch = nullptr; });
+        attachAll();
+    }
+    DEBUG << "Attaching" << windows.size() << "windows took" << timer.nsecsElapsed() << "ns.";
+    if (batch.helpers.isEmpty()) {
+        return helpers;
+    }
+    QTimer::singleShot(batch.waitTime, FramelessManager::instance(), [pendingHelpers = std::move(batch.helpers)](){
+        for (auto &&helper : std::as_const(pendingHelpers)) {
+            if (helper) {
+                FramelessWidgetsHelperPrivate::get(helper)->handleQpaReady();
+            }
+        }
+    });
+    return helpers;
+}
+
 void FramelessWidgetsHelperPrivate::repaintAllChildren(const quint32 delay) const
 {
     if (!window) {
         return;
     }
     const auto update = [this]() -> void {
-        forceWidgetRepaint(window);
-        const QList<QWidget *> widgets = window->findChildren<QWidget *>();
-        if (widgets.isEmpty()) {
+        if (!window) {
             return;
         }
+        QElapsedTimer timer = {};
+        timer.start();
+        FramelessWidgetsHelperData * const data = getWindowDataMutable();
+        if (data && !FramelessConfig::instance()->isSet(Option::ForceFullChildrenRepaint)) {
+            const int count = repaintWidgetTree(window, data->nativeChildDevicePixelRatios);
+            DEBUG << "Repainting" << count << "widgets took" << timer.nsecsElapsed() << "ns.";
+            return;
+        }
+        // The old way: resize and move every single widget to make sure it repaints,
+        // which may trigger a huge amount of layout work for complex windows.
+        forceWidgetRepaint(window);
+        const QList<QWidget *> widgets = window->findChildren<QWidget *>();
         for (auto &&widget : std::as_const(widgets)) {
             forceWidgetRepaint(widget);
         }
+        DEBUG << "Force repainting" << (widgets.size() + 1) << "widgets took" << timer.nsecsElapsed() << "ns.";
     };
     if (delay > 0) {
         QTimer::singleShot(delay, this, update);
@@ -369,6 +552,7 @@ void FramelessWidgetsHelperPrivate::attach()
         return;
     }
     window = tlw;
+    windowData.reset();
 
     if (!window->testAttribute(Qt::WA_DontCreateNativeAncestors)) {
         window->setAttribute(Qt::WA_DontCreateNativeAncestors);
@@ -384,79 +568,40 @@ void FramelessWidgetsHelperPrivate::attach()
 
     Q_Q(FramelessWidgetsHelper);
 
-    SystemParameters params = {};
-    params.getWindowId = [this]() -> WId { return window->winId(); };
-    params.getWindowFlags = [this]() -> Qt::WindowFlags { return window->windowFlags(); };
-    params.setWindowFlags = [this](const Qt::WindowFlags flags) -> void { window->setWindowFlags(flags); };
-    params.getWindowSize = [this]() -> QSize { return window->size(); };
-    params.setWindowSize = [this](const QSize &size) -> void { window->resize(size); };
-    params.getWindowPosition = [this]() -> QPoint { return window->pos(); };
-    params.setWindowPosition = [this](const QPoint &pos) -> void { window->move(pos); };
-    params.getWindowScreen = [this]() -> QScreen * {
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
-        return window->screen();
-#else
-        return window->windowHandle()->screen();
-#endif
-    };
-    params.isWindowFixedSize = [q]() -> bool { return q->isWindowFixedSize(); };
-    params.setWindowFixedSize = [q](const bool value) -> void { q->setWindowFixedSize(value); };
-    params.getWindowState = [this]() -> Qt::WindowState { return Utils::windowStatesToWindowState(window->windowState()); };
-    params.setWindowState = [this](const Qt::WindowState state) -> void { window->setWindowState(state); };
-    params.getWindowHandle = [this]() -> QWindow * { return window->windowHandle(); };
-    params.windowToScreen = [this](const QPoint &pos) -> QPoint { return window->mapToGlobal(pos); };
-    params.screenToWindow = [this](const QPoint &pos) -> QPoint { return window->mapFromGlobal(pos); };
-    params.isInsideSystemButtons = [this](const QPoint &pos, SystemButtonType *button) -> bool { return isInSystemButtons(pos, button); };
-    params.isInsideTitleBarDraggableArea = [this](const QPoint &pos) -> bool { return isInTitleBarDraggableArea(pos); };
-    params.getWindowDevicePixelRatio = [this]() -> qreal { return window->devicePixelRatioF(); };
-    params.setSystemButtonState = [this](const SystemButtonType button, const ButtonState state) -> void { setSystemButtonState(button, state); };
-    params.shouldIgnoreMouseEvents = [this](const QPoint &pos) -> bool { return shouldIgnoreMouseEvents(pos); };
-    params.showSystemMenu = [q](const QPoint &pos) -> void { q->showSystemMenu(pos); };
-    params.setProperty = [this](const char *name, const QVariant &value) -> void { setProperty(name, value); };
-    params.getProperty = [this](const char *name, const QVariant &defaultValue) -> QVariant { return getProperty(name, defaultValue); };
-    params.setCursor = [this](const QCursor &cursor) -> void { window->setCursor(cursor); };
-    params.unsetCursor = [this]() -> void { window->unsetCursor(); };
-    params.getWidgetHandle = [this]() -> QObject * { return window; };
-    params.forceChildrenRepaint = [this](const int delay) -> void { repaintAllChildren(delay); };
-    params.resetQtGrabbedControl = []() -> bool {
-        if (qt_button_down) {
-            static constexpr const auto invalidPos = QPoint{ -99999, -99999 };
-            const auto event = std::make_unique<QMouseEvent>(
-                QEvent::MouseButtonRelease,
-                invalidPos,
-                invalidPos,
-                invalidPos,
-                Qt::LeftButton,
-                QGuiApplication::mouseButtons() ^ Qt::LeftButton,
-                QGuiApplication::keyboardModifiers());
-            QApplication::sendEvent(qt_button_down, event.get());
-            qt_button_down = nullptr;
-            return true;
-        }
-        return false;
-    };
+    const auto params = std::make_shared<FramelessWidgetsSystemParameters>(this);
 
-    FramelessManager::instance()->addWindow(&params);
+    FramelessManager::instance()->addWindow(params);
 
     data->params = params;
     data->ready = true;
 
+    // The whole batch shares one timer, which is started once all its windows are attached.
+    if (FramelessWidgetsHelperBatch * const batch = g_currentFramelessWidgetsHelperBatch) {
+        batch->helpers.append(q);
+        batch->waitTime = qMax(batch->waitTime, qpaWaitTime);
+        return;
+    }
+
     // We have to wait for a little time before moving the top level window
     // , because the platform window may not finish initializing by the time
     // we reach here, and all the modifications from the Qt side will be lost
     // due to QPA will reset the position and size of the window during it's
     // initialization process.
-    QTimer::singleShot(qpaWaitTime, this, [this, q](){
-        qpaReady = true;
-        if (FramelessConfig::instance()->isSet(Option::CenterWindowBeforeShow)) {
-            q->moveWindowToDesktopCenter();
-        }
-        if (FramelessConfig::instance()->isSet(Option::EnableBlurBehindWindow)) {
-            q->setBlurBehindWindowEnabled(true);
-        }
-        emitSignalForAllInstances("windowChanged");
-        emitSignalForAllInstances("ready");
-    });
+    QTimer::singleShot(qpaWaitTime, this, &FramelessWidgetsHelperPrivate::handleQpaReady);
+}
+
+void FramelessWidgetsHelperPrivate::handleQpaReady()
+{
+    Q_Q(FramelessWidgetsHelper);
+    qpaReady = true;
+    if (FramelessConfig::instance()->isSet(Option::CenterWindowBeforeShow)) {
+        q->moveWindowToDesktopCenter();
+    }
+    if (FramelessConfig::instance()->isSet(Option::EnableBlurBehindWindow)) {
+        q->setBlurBehindWindowEnabled(true);
+    }
+    emitSignalForAllInstances("windowChanged");
+    emitSignalForAllInstances("ready");
 }
 
 void FramelessWidgetsHelperPrivate::detach()
@@ -464,14 +609,18 @@ void FramelessWidgetsHelperPrivate::detach()
     if (!window) {
         return;
     }
-    const WId windowId = window->winId();
-    const auto it = g_framelessWidgetsHelperData()->constFind(windowId);
+    const auto it = g_framelessWidgetsHelperData()->constFind(window);
     if (it == g_framelessWidgetsHelperData()->constEnd()) {
         return;
     }
+    disconnect(it.value()->destroyedConnection);
     g_framelessWidgetsHelperData()->erase(it);
-    FramelessManager::instance()->removeWindow(windowId);
+    // winId() would create a native window just to remove it again.
+    if (const WId windowId = window->internalWinId()) {
+        FramelessManager::instance()->removeWindow(windowId);
+    }
     window = nullptr;
+    windowData.reset();
     emitSignalForAllInstances("windowChanged");
 }
 
@@ -490,16 +639,7 @@ QWidget *FramelessWidgetsHelperPrivate::findTopLevelWindow() const
 
 const FramelessWidgetsHelperData *FramelessWidgetsHelperPrivate::getWindowData() const
 {
-    //Q_ASSERT(window);
-    if (!window) {
-        return nullptr;
-    }
-    const WId windowId = window->winId();
-    auto it = g_framelessWidgetsHelperData()->find(windowId);
-    if (it == g_framelessWidgetsHelperData()->end()) {
-        it = g_framelessWidgetsHelperData()->insert(windowId, {});
-    }
-    return &it.value();
+    return getWindowDataMutable();
 }
 
 FramelessWidgetsHelperData *FramelessWidgetsHelperPrivate::getWindowDataMutable() const
@@ -508,12 +648,22 @@ FramelessWidgetsHelperData *FramelessWidgetsHelperPrivate::getWindowDataMutable(
     if (!window) {
         return nullptr;
     }
-    const WId windowId = window->winId();
-    auto it = g_framelessWidgetsHelperData()->find(windowId);
-    if (it == g_framelessWidgetsHelperData()->end()) {
-        it = g_framelessWidgetsHelperData()->insert(windowId, {});
+    // The registry keeps the data alive, unless another helper of the
+    // same window has detached it in the mean time.
+    if (const std::shared_ptr<FramelessWidgetsHelperData> data = windowData.lock()) {
+        return data.get();
     }
-    return &it.value();
+    const QWidget * const key = window;
+    auto it = g_framelessWidgetsHelperData()->find(key);
+    if (it == g_framelessWidgetsHelperData()->end()) {
+        it = g_framelessWidgetsHelperData()->insert(key, std::make_shared<FramelessWidgetsHelperData>());
+        // Don't let a new window at the same address inherit the data.
+        it.value()->destroyedConnection = connect(window, &QWidget::destroyed, FramelessManager::instance(), [key](){
+            g_framelessWidgetsHelperData()->remove(key);
+        });
+    }
+    windowData = it.value();
+    return it.value().get();
 }
 
 QRect FramelessWidgetsHelperPrivate::mapWidgetGeometryToScene(const QWidget * const widget) const
@@ -531,12 +681,16 @@ QRect FramelessWidgetsHelperPrivate::mapWidgetGeometryToScene(const QWidget * co
 }
 
 bool FramelessWidgetsHelperPrivate::isInSystemButtons(const QPoint &pos, SystemButtonType *button) const
+{
+    return isInSystemButtons(getWindowData(), pos, button);
+}
+
+bool FramelessWidgetsHelperPrivate::isInSystemButtons(const FramelessWidgetsHelperData *data, const QPoint &pos, SystemButtonType *button) const
 {
     Q_ASSERT(button);
     if (!button) {
         return false;
     }
-    const FramelessWidgetsHelperData *data = getWindowData();
     if (!data) {
         return false;
     }
@@ -576,31 +730,47 @@ bool FramelessWidgetsHelperPrivate::isInSystemButtons(const QPoint &pos, SystemB
 
 bool FramelessWidgetsHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos) const
 {
-    const FramelessWidgetsHelperData *data = getWindowData();
+    return isInTitleBarDraggableArea(getWindowDataMutable(), pos);
+}
+
+bool FramelessWidgetsHelperPrivate::isInTitleBarDraggableArea(FramelessWidgetsHelperData *data, const QPoint &pos) const
+{
     if (!data) {
         return false;
     }
+    if (!data->titleBarHitTestIndex.has_value()) {
+        data->titleBarHitTestIndex = calculateTitleBarHitTestIndex();
+    }
+    return data->titleBarHitTestIndex.value().isInFreeArea(pos);
+}
+
+HitTestIndex FramelessWidgetsHelperPrivate::calculateTitleBarHitTestIndex() const
+{
+    const FramelessWidgetsHelperData *data = getWindowData();
+    if (!data) {
+        return {};
+    }
     if (!data->titleBarWidget) {
         // There's no title bar at all, the mouse will always be in the client area.
-        return false;
+        return {};
     }
     if (!data->titleBarWidget->isVisible() || !data->titleBarWidget->isEnabled()) {
         // The title bar is hidden or disabled for some reason, treat it as there's no title bar.
-        return false;
+        return {};
     }
     if (!window) {
         // The FramelessWidgetsHelper object has not been attached to a specific window yet,
         // so we assume there's no title bar.
-        return false;
+        return {};
     }
     const QRect windowRect = {QPoint(0, 0), window->size()};
     const QRect titleBarRect = mapWidgetGeometryToScene(data->titleBarWidget);
     if (!titleBarRect.intersects(windowRect)) {
         // The title bar is totally outside of the window for some reason,
         // also treat it as there's no title bar.
-        return false;
+        return {};
     }
-    QRegion region = titleBarRect;
+    QList<QRect> rects = {};
     const auto systemButtons = {
         data->windowIconButton, data->contextHelpButton,
         data->minimizeButton, data->maximizeButton,
@@ -608,24 +778,94 @@ bool FramelessWidgetsHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos)
     };
     for (auto &&button : std::as_const(systemButtons)) {
         if (button && button->isVisible() && button->isEnabled()) {
-            region -= mapWidgetGeometryToScene(button);
+            rects.append(mapWidgetGeometryToScene(button));
         }
     }
     if (!data->hitTestVisibleWidgets.isEmpty()) {
         for (auto &&widget : std::as_const(data->hitTestVisibleWidgets)) {
             if (widget && widget->isVisible() && widget->isEnabled()) {
-                region -= mapWidgetGeometryToScene(widget);
+                rects.append(mapWidgetGeometryToScene(widget));
             }
         }
     }
     if (!data->hitTestVisibleRects.isEmpty()) {
         for (auto &&rect : std::as_const(data->hitTestVisibleRects)) {
             if (rect.isValid()) {
-                region -= rect;
+                rects.append(rect);
             }
         }
     }
-    return region.contains(pos);
+    return HitTestIndex(titleBarRect, rects);
+}
+
+void FramelessWidgetsHelperPrivate::invalidateTitleBarHitTestIndex()
+{
+    if (const std::shared_ptr<FramelessWidgetsHelperData> data = windowData.lock()) {
+        data->titleBarHitTestIndex = std::nullopt;
+        return;
+    }
+    // This may be called while the window is being destroyed, so don't create the window data here.
+    if (!window) {
+        return;
+    }
+    const auto it = g_framelessWidgetsHelperData()->find(window);
+    if (it == g_framelessWidgetsHelperData()->end()) {
+        return;
+    }
+    it.value()->titleBarHitTestIndex = std::nullopt;
+}
+
+void FramelessWidgetsHelperPrivate::watchHitTestWidget(QWidget *widget)
+{
+    Q_ASSERT(widget);
+    if (!widget) {
+        return;
+    }
+    // The position of a widget inside the window also changes when any of its
+    // parents moves, so the whole parent chain has to be watched.
+    // Installing the same event filter twice is harmless, Qt only keeps one.
+    for (QWidget *w = widget; w; w = w->parentWidget()) {
+        w->installEventFilter(this);
+        connect(w, &QObject::destroyed, this,
+            &FramelessWidgetsHelperPrivate::invalidateTitleBarHitTestIndex, Qt::UniqueConnection);
+        if (w->isWindow()) {
+            break;
+        }
+    }
+    invalidateTitleBarHitTestIndex();
+}
+
+bool FramelessWidgetsHelperPrivate::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    if (!object || !event) {
+        return false;
+    }
+    if (!object->isWidgetType()) {
+        return QObject::eventFilter(object, event);
+    }
+    const auto widget = static_cast<QWidget *>(object);
+    switch (event->type()) {
+    case QEvent::Move:
+        // Moving the whole window doesn't change anything inside of it.
+        if (!widget->isWindow()) {
+            invalidateTitleBarHitTestIndex();
+        }
+        break;
+    case QEvent::Resize:
+    case QEvent::Show:
+    case QEvent::Hide:
+    case QEvent::EnabledChange:
+        invalidateTitleBarHitTestIndex();
+        break;
+    case QEvent::ParentChange:
+        watchHitTestWidget(widget);
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(object, event);
 }
 
 bool FramelessWidgetsHelperPrivate::shouldIgnoreMouseEvents(const QPoint &pos) const
@@ -648,6 +888,28 @@ bool FramelessWidgetsHelperPrivate::shouldIgnoreMouseEvents(const QPoint &pos) c
     return ((Utils::windowStatesToWindowState(window->windowState()) == Qt::WindowNoState) && withinFrameBorder);
 }
 
+HitTestResult FramelessWidgetsHelperPrivate::hitTest(const QPoint &pos, const bool querySystemButton) const
+{
+    HitTestResult result = {};
+    if (!window) {
+        return result;
+    }
+    // Look up the window data only once for everything.
+    FramelessWidgetsHelperData * const data = getWindowDataMutable();
+    const QWindow * const windowHandle = window->windowHandle();
+    result.windowEdges = Utils::calculateWindowEdges(windowHandle, pos);
+    result.cursorShape = Utils::calculateCursorShape(windowHandle, pos);
+    if (querySystemButton) {
+        std::ignore = isInSystemButtons(data, pos, &result.systemButton);
+    }
+    result.insideTitleBarDraggableArea = isInTitleBarDraggableArea(data, pos);
+    result.shouldIgnoreMouseEvents = shouldIgnoreMouseEvents(pos);
+    result.windowFixedSize = isWidgetFixedSize(window);
+    result.dontOverrideCursor = window->property(kDontOverrideCursorVar).toBool();
+    result.dontToggleMaximize = window->property(kDontToggleMaximizeVar).toBool();
+    return result;
+}
+
 void FramelessWidgetsHelperPrivate::setSystemButtonState(const SystemButtonType button, const ButtonState state)
 {
     Q_UNUSED(button);
@@ -660,7 +922,11 @@ void FramelessWidgetsHelper::moveWindowToDesktopCenter()
     if (!d->window) {
         return;
     }
-    Utils::moveWindowToDesktopCenter(&d->getWindowData()->params, true);
+    const FramelessWidgetsHelperData * const data = d->getWindowData();
+    if (!data || !data->params) {
+        return;
+    }
+    Utils::moveWindowToDesktopCenter(data->params.get(), true);
 }
 
 void FramelessWidgetsHelper::bringWindowToFront()
@@ -692,7 +958,11 @@ void FramelessWidgetsHelper::showSystemMenu(const QPoint &pos)
     const WId windowId = d->window->winId();
     const QPoint nativePos = Utils::toNativeGlobalPosition(d->window->windowHandle(), pos);
 #ifdef Q_OS_WINDOWS
-    std::ignore = Utils::showSystemMenu(windowId, nativePos, false, &d->getWindowData()->params);
+    const FramelessWidgetsHelperData * const data = d->getWindowData();
+    if (!data || !data->params) {
+        return;
+    }
+    std::ignore = Utils::showSystemMenu(windowId, nativePos, false, data->params.get());
 #elif (defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID))
     Utils::openSystemMenu(windowId, nativePos);
 #else
@@ -754,6 +1024,7 @@ void FramelessWidgetsHelper::setSystemButton(QWidget *widget, const SystemButton
     case SystemButtonType::Unknown:
         Q_UNREACHABLE();
     }
+    d->watchHitTestWidget(widget);
 }
 
 FramelessWidgetsHelper::FramelessWidgetsHelper(QObject *parent)
@@ -772,6 +1043,11 @@ FramelessWidgetsHelper *FramelessWidgetsHelper::get(QObject *object)
     return FramelessWidgetsHelperPrivate::findOrCreateFramelessHelper(object);
 }
 
+QList<FramelessWidgetsHelper *> FramelessWidgetsHelper::get(const QList<QWidget *> &windows)
+{
+    return FramelessWidgetsHelperPrivate::findOrCreateFramelessHelpers(windows);
+}
+
 QWidget *FramelessWidgetsHelper::window() const
 {
     Q_D(const FramelessWidgetsHelper);
@@ -911,6 +1187,7 @@ void FramelessWidgetsHelper::setTitleBarWidget(QWidget *widget)
         return;
     }
     data->titleBarWidget = widget;
+    d->watchHitTestWidget(widget);
     d->emitSignalForAllInstances("titleBarWidgetChanged");
 }
 
@@ -934,8 +1211,10 @@ void FramelessWidgetsHelper::setHitTestVisible(QWidget *widget, const bool visib
     }
     if (visible) {
         data->hitTestVisibleWidgets.append(widget);
+        d->watchHitTestWidget(widget);
     } else {
         data->hitTestVisibleWidgets.removeAll(widget);
+        d->invalidateTitleBarHitTestIndex();
     }
 }
 
@@ -955,6 +1234,7 @@ void FramelessWidgetsHelper::setHitTestVisible(const QRect &rect, const bool vis
     } else {
         data->hitTestVisibleRects.removeAll(rect);
     }
+    d->invalidateTitleBarHitTestIndex();
 }
 
 void FramelessWidgetsHelper::setHitTestVisible(QObject *object, const bool visible)
@@ -269,7 +269,7 @@ void WidgetsSharedHelper::handleScreenChanged(QScreen *screen)
             m_screenDpr = currentDpr;
 #if FRAMELESSHELPER_CONFIG(mica_material)
             if (m_micaEnabled) {
-                MicaMaterialPrivate::get(m_micaMaterial)->maybeGenerateBlurredWallpaper(true);
+                MicaMaterialPrivate::get(m_micaMaterial)->maybeGenerateBlurredWallpaper(m_screen, true);
             }
 #endif
         });
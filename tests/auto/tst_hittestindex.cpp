@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <FramelessHelper/Core/private/hittestindex_p.h>
+#include <QtTest/qtest.h>
+#include <QtGui/qregion.h>
+#include <random>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+static constexpr const QRect kTitleBarRect = { 12, 6, 1200, 40 };
+
+// Some of them stick out of the title bar, some are outside of it entirely.
+[[nodiscard]] static inline QList<QRect> createRects(const int count)
+{
+    std::mt19937 generator(20231016);
+    std::uniform_int_distribution<int> x((kTitleBarRect.left() - 40), (kTitleBarRect.right() + 10));
+    std::uniform_int_distribution<int> y((kTitleBarRect.top() - 20), (kTitleBarRect.bottom() + 5));
+    std::uniform_int_distribution<int> width(1, 80);
+    std::uniform_int_distribution<int> height(1, 50);
+    QList<QRect> rects = {};
+    rects.reserve(count);
+    for (int i = 0; i != count; ++i) {
+        rects.append(QRect(x(generator), y(generator), width(generator), height(generator)));
+    }
+    return rects;
+}
+
+class tst_HitTestIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void emptyIndex();
+    void matchesRegion_data();
+    void matchesRegion();
+};
+
+void tst_HitTestIndex::emptyIndex()
+{
+    const HitTestIndex invalid = {};
+    QVERIFY(!invalid.isInFreeArea(QPoint(0, 0)));
+
+    const HitTestIndex noRects(kTitleBarRect, {});
+    QVERIFY(noRects.isInFreeArea(kTitleBarRect.topLeft()));
+    QVERIFY(noRects.isInFreeArea(kTitleBarRect.bottomRight()));
+    QVERIFY(!noRects.isInFreeArea(kTitleBarRect.topLeft() - QPoint(1, 0)));
+    QVERIFY(!noRects.isInFreeArea(kTitleBarRect.bottomRight() + QPoint(0, 1)));
+}
+
+void tst_HitTestIndex::matchesRegion_data()
+{
+    QTest::addColumn<QList<QRect>>("rects");
+
+    QTest::newRow("one rect") << QList<QRect>{ QRect(100, 10, 30, 20) };
+    QTest::newRow("covers everything") << QList<QRect>{ kTitleBarRect.adjusted(-1, -1, 1, 1) };
+    QTest::newRow("outside") << QList<QRect>{ QRect(0, 0, 5, 5), QRect(2000, 10, 30, 20) };
+    QTest::newRow("invalid") << QList<QRect>{ QRect(), QRect(50, 10, 0, 20), QRect(80, 10, -10, 20) };
+    QTest::newRow("10 rects") << createRects(10);
+    QTest::newRow("100 rects") << createRects(100);
+    QTest::newRow("1000 rects") << createRects(1000);
+}
+
+void tst_HitTestIndex::matchesRegion()
+{
+    QFETCH(QList<QRect>, rects);
+
+    const HitTestIndex index(kTitleBarRect, rects);
+    // This is how the title bar was checked before the index existed.
+    QRegion region = kTitleBarRect;
+    for (auto &&rect : std::as_const(rects)) {
+        region -= rect;
+    }
+    // Every pixel of the title bar and a margin around it, edges are where it usually goes wrong.
+    const QRect testRect = kTitleBarRect.adjusted(-3, -3, 3, 3);
+    for (int y = testRect.top(); y <= testRect.bottom(); ++y) {
+        for (int x = testRect.left(); x <= testRect.right(); ++x) {
+            const QPoint pos(x, y);
+            if (index.isInFreeArea(pos) != region.contains(pos)) {
+                QFAIL(qPrintable(FRAMELESSHELPER_STRING_LITERAL("Mismatch at (%1, %2).").arg(x).arg(y)));
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_HitTestIndex)
+
+#include "tst_hittestindex.moc"
@@ -0,0 +1,172 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <FramelessHelper/Core/utils.h>
+#include <QtTest/qtest.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtGui/qguiapplication.h>
+#include <array>
+#include <cstdlib>
+#include <limits>
+#include <tuple>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+// Keep in sync with X11_ATOMS in utils_linux.cpp, this is what a frameless window interns at startup.
+static constexpr const std::array kKnownAtomNames = {
+    "_NET_SUPPORTED",
+    "_NET_WM_NAME",
+    "_NET_WM_MOVERESIZE",
+    "_NET_SUPPORTING_WM_CHECK",
+    "_NET_KDE_COMPOSITE_TOGGLING",
+    "_KDE_NET_WM_BLUR_BEHIND_REGION",
+    "_GTK_SHOW_WINDOW_MENU",
+    "_DEEPIN_NO_TITLEBAR",
+    "_DEEPIN_FORCE_DECORATE",
+    "_NET_WM_DEEPIN_BLUR_REGION_MASK",
+    "_NET_WM_DEEPIN_BLUR_REGION_ROUNDED",
+    "UTF8_STRING"
+};
+
+using Atoms = std::array<xcb_atom_t, kKnownAtomNames.size()>;
+
+// The best of several runs, so that a busy machine doesn't make the numbers meaningless.
+static constexpr const int kRepeatCount = 50;
+
+// One blocking reply per request: one round trip per atom, the way it used to be done.
+[[nodiscard]] static inline Atoms internSequentially(xcb_connection_t *connection)
+{
+    Atoms atoms = {};
+    for (std::size_t index = 0; index != kKnownAtomNames.size(); ++index) {
+        const char * const name = kKnownAtomNames[index];
+        const xcb_intern_atom_cookie_t cookie = xcb_intern_atom(connection, false, qstrlen(name), name);
+        xcb_intern_atom_reply_t * const reply = xcb_intern_atom_reply(connection, cookie, nullptr);
+        if (reply) {
+            atoms[index] = reply->atom;
+            std::free(reply);
+        }
+    }
+    return atoms;
+}
+
+// All requests first, then all replies: one round trip for the whole set.
+[[nodiscard]] static inline Atoms internBatched(xcb_connection_t *connection)
+{
+    Atoms atoms = {};
+    std::array<xcb_intern_atom_cookie_t, kKnownAtomNames.size()> cookies = {};
+    for (std::size_t index = 0; index != kKnownAtomNames.size(); ++index) {
+        const char * const name = kKnownAtomNames[index];
+        cookies[index] = xcb_intern_atom(connection, false, qstrlen(name), name);
+    }
+    for (std::size_t index = 0; index != kKnownAtomNames.size(); ++index) {
+        xcb_intern_atom_reply_t * const reply = xcb_intern_atom_reply(connection, cookies[index], nullptr);
+        if (reply) {
+            atoms[index] = reply->atom;
+            std::free(reply);
+        }
+    }
+    return atoms;
+}
+
+template<typename Function>
+[[nodiscard]] static inline qint64 bestOf(Function &&function)
+{
+    qint64 best = std::numeric_limits<qint64>::max();
+    QElapsedTimer timer = {};
+    for (int i = 0; i != kRepeatCount; ++i) {
+        timer.start();
+        function();
+        best = qMin(best, timer.nsecsElapsed());
+    }
+    return best;
+}
+
+class tst_X11Atoms : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void matchesInternAtom();
+    void roundTrips();
+
+private:
+    xcb_connection_t *m_connection = nullptr;
+};
+
+void tst_X11Atoms::initTestCase()
+{
+    if (QGuiApplication::platformName() != FRAMELESSHELPER_STRING_LITERAL("xcb")) {
+        QSKIP("Needs an X server, run it with xvfb-run.");
+    }
+    m_connection = Utils::x11_connection();
+    QVERIFY(m_connection);
+}
+
+void tst_X11Atoms::matchesInternAtom()
+{
+    const Atoms batched = internBatched(m_connection);
+    const Atoms sequential = internSequentially(m_connection);
+    for (std::size_t index = 0; index != kKnownAtomNames.size(); ++index) {
+        const xcb_atom_t atom = Utils::internAtom(kKnownAtomNames[index]);
+        QVERIFY2(atom != XCB_NONE, kKnownAtomNames[index]);
+        QCOMPARE(batched[index], atom);
+        QCOMPARE(sequential[index], atom);
+    }
+}
+
+void tst_X11Atoms::roundTrips()
+{
+    // A single blocking request is the cost of one round trip on this connection.
+    const qint64 roundTrip = bestOf([this](){
+        const xcb_intern_atom_cookie_t cookie = xcb_intern_atom(m_connection, false, qstrlen(kKnownAtomNames[0]), kKnownAtomNames[0]);
+        std::free(xcb_intern_atom_reply(m_connection, cookie, nullptr));
+    });
+    const qint64 sequential = bestOf([this](){ std::ignore = internSequentially(m_connection); });
+    const qint64 batched = bestOf([this](){ std::ignore = internBatched(m_connection); });
+    const auto roundTrips = [roundTrip](const qint64 elapsed) -> qreal {
+        return (qreal(elapsed) / qreal(qMax(roundTrip, qint64(1))));
+    };
+    qInfo().nospace() << "Interning " << kKnownAtomNames.size() << " atoms: sequential "
+                      << sequential << "ns (~" << roundTrips(sequential) << " round trips), batched "
+                      << batched << "ns (~" << roundTrips(batched) << " round trips), one round trip "
+                      << roundTrip << "ns.";
+    // One round trip instead of one per atom, leave plenty of room for noise.
+    QVERIFY(batched < sequential);
+    QVERIFY(roundTrips(batched) < (qreal(kKnownAtomNames.size()) / 2));
+}
+
+int main(int argc, char *argv[])
+{
+    // Without an X server the xcb plugin would abort, skip instead.
+    if (qEnvironmentVariableIsEmpty("DISPLAY") && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication application(argc, argv);
+    tst_X11Atoms test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_x11atoms.moc"
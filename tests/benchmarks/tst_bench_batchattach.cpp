@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <FramelessHelper/Widgets/framelesswidgetshelper.h>
+#include <QtTest/qtest.h>
+#include <QtWidgets/qwidget.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+class tst_Bench_BatchAttach : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void startup_data();
+    void startup();
+};
+
+void tst_Bench_BatchAttach::startup_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("batch");
+
+    for (auto &&count : { 10, 50, 200 }) {
+        QTest::addRow("%d windows, one by one", count) << count << false;
+        QTest::addRow("%d windows, batch", count) << count << true;
+    }
+}
+
+// Each iteration creates the windows, attaches them and waits until all of them are ready.
+void tst_Bench_BatchAttach::startup()
+{
+    QFETCH(int, count);
+    QFETCH(bool, batch);
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QWidget>> windows = {};
+        QList<QWidget *> windowList = {};
+        for (int i = 0; i != count; ++i) {
+            windows.push_back(std::make_unique<QWidget>());
+            windowList.append(windows.back().get());
+        }
+        QList<FramelessWidgetsHelper *> helpers = {};
+        if (batch) {
+            helpers = FramelessWidgetsHelper::get(windowList);
+        } else {
+            for (auto &&window : std::as_const(windowList)) {
+                helpers.append(FramelessWidgetsHelper::get(window));
+            }
+        }
+        QCOMPARE(helpers.size(), count);
+        QTRY_VERIFY_WITH_TIMEOUT(std::all_of(helpers.cbegin(), helpers.cend(),
+            [](const FramelessWidgetsHelper *helper){ return helper->isReady(); }), 10000);
+    }
+}
+
+QTEST_MAIN(tst_Bench_BatchAttach)
+
+#include "tst_bench_batchattach.moc"
@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <FramelessHelper/Widgets/framelesswidgetshelper.h>
+#include <FramelessHelper/Widgets/private/framelesswidgetshelper_p.h>
+#include <FramelessHelper/Core/private/framelessconfig_p.h>
+#include <QtTest/qtest.h>
+#include <QtWidgets/qwidget.h>
+#include <QtWidgets/qlabel.h>
+#include <QtWidgets/qgridlayout.h>
+#include <memory>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+// 1000 widgets, every 100th of them has its own native window.
+static constexpr const int kRowCount = 40;
+static constexpr const int kColumnCount = 25;
+static constexpr const int kNativeInterval = 100;
+
+class tst_Bench_ChildrenRepaint : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void repaint_data();
+    void repaint();
+
+private:
+    std::unique_ptr<QWidget> m_window = nullptr;
+    FramelessWidgetsHelper *m_helper = nullptr;
+};
+
+void tst_Bench_ChildrenRepaint::initTestCase()
+{
+    m_window = std::make_unique<QWidget>();
+    const auto layout = new QGridLayout(m_window.get());
+    for (int i = 0; i != (kRowCount * kColumnCount); ++i) {
+        const auto label = new QLabel(QString::number(i), m_window.get());
+        if ((i % kNativeInterval) == 0) {
+            label->setAttribute(Qt::WA_NativeWindow);
+        }
+        layout->addWidget(label, (i / kColumnCount), (i % kColumnCount));
+    }
+    m_helper = FramelessWidgetsHelper::get(m_window.get());
+    QVERIFY(m_helper);
+    m_helper->extendsContentIntoTitleBar();
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window.get()));
+}
+
+void tst_Bench_ChildrenRepaint::cleanupTestCase()
+{
+    FramelessConfig::instance()->set(Global::Option::ForceFullChildrenRepaint, false);
+    m_window.reset();
+}
+
+void tst_Bench_ChildrenRepaint::repaint_data()
+{
+    QTest::addColumn<bool>("forceFullRepaint");
+
+    QTest::newRow("resize and move everything") << true;
+    QTest::newRow("backing store and changed native children") << false;
+}
+
+// Each iteration is one DPI change, including the layout and paint work it causes.
+// The DPR doesn't really change here, so after the first iteration the targeted repaint
+// skips all the native children. On a real change it updates each of them once.
+void tst_Bench_ChildrenRepaint::repaint()
+{
+    QFETCH(bool, forceFullRepaint);
+
+    FramelessConfig::instance()->set(Global::Option::ForceFullChildrenRepaint, forceFullRepaint);
+    const FramelessWidgetsHelperPrivate * const d = FramelessWidgetsHelperPrivate::get(m_helper);
+    QBENCHMARK {
+        d->repaintAllChildren();
+        QCoreApplication::processEvents();
+    }
+}
+
+QTEST_MAIN(tst_Bench_ChildrenRepaint)
+
+#include "tst_bench_childrenrepaint.moc"
@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <FramelessHelper/Core/private/hittestindex_p.h>
+#include <QtTest/qtest.h>
+#include <QtGui/qregion.h>
+#include <random>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+static constexpr const QRect kTitleBarRect = { 0, 0, 1920, 40 };
+static constexpr const int kQueryCount = 1000;
+
+[[nodiscard]] static inline QList<QRect> createRects(const int count)
+{
+    std::mt19937 generator(20231016);
+    std::uniform_int_distribution<int> x(kTitleBarRect.left(), kTitleBarRect.right());
+    std::uniform_int_distribution<int> y(kTitleBarRect.top(), kTitleBarRect.bottom());
+    std::uniform_int_distribution<int> size(8, 32);
+    QList<QRect> rects = {};
+    rects.reserve(count);
+    for (int i = 0; i != count; ++i) {
+        rects.append(QRect(x(generator), y(generator), size(generator), size(generator)));
+    }
+    return rects;
+}
+
+[[nodiscard]] static inline QList<QPoint> createPoints()
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> x(kTitleBarRect.left(), kTitleBarRect.right());
+    std::uniform_int_distribution<int> y(kTitleBarRect.top(), kTitleBarRect.bottom());
+    QList<QPoint> points = {};
+    points.reserve(kQueryCount);
+    for (int i = 0; i != kQueryCount; ++i) {
+        points.append(QPoint(x(generator), y(generator)));
+    }
+    return points;
+}
+
+class tst_Bench_HitTestIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void query_data();
+    void query();
+    void build_data();
+    void build();
+};
+
+void tst_Bench_HitTestIndex::query_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("useIndex");
+
+    for (auto &&count : { 10, 100, 1000 }) {
+        QTest::addRow("%d rects, region", count) << count << false;
+        QTest::addRow("%d rects, index", count) << count << true;
+    }
+}
+
+// Each iteration is a burst of mouse moves over the title bar.
+void tst_Bench_HitTestIndex::query()
+{
+    QFETCH(int, count);
+    QFETCH(bool, useIndex);
+
+    const QList<QRect> rects = createRects(count);
+    const QList<QPoint> points = createPoints();
+    const HitTestIndex index(kTitleBarRect, rects);
+    int hits = 0;
+    if (useIndex) {
+        QBENCHMARK {
+            for (auto &&point : std::as_const(points)) {
+                hits += (index.isInFreeArea(point) ? 1 : 0);
+            }
+        }
+    } else {
+        // The old code subtracted every rect from the title bar on each hit test.
+        QBENCHMARK {
+            for (auto &&point : std::as_const(points)) {
+                QRegion region = kTitleBarRect;
+                for (auto &&rect : std::as_const(rects)) {
+                    region -= rect;
+                }
+                hits += (region.contains(point) ? 1 : 0);
+            }
+        }
+    }
+    QVERIFY(hits >= 0);
+}
+
+void tst_Bench_HitTestIndex::build_data()
+{
+    QTest::addColumn<int>("count");
+
+    for (auto &&count : { 10, 100, 1000 }) {
+        QTest::addRow("%d rects", count) << count;
+    }
+}
+
+// Only paid when the registered elements or the title bar change.
+void tst_Bench_HitTestIndex::build()
+{
+    QFETCH(int, count);
+
+    const QList<QRect> rects = createRects(count);
+    QBENCHMARK {
+        const HitTestIndex index(kTitleBarRect, rects);
+        Q_UNUSED(index);
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_Bench_HitTestIndex)
+
+#include "tst_bench_hittestindex.moc"
@@ -0,0 +1,194 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <FramelessHelper/Core/micamaterial.h>
+#include <FramelessHelper/Core/private/micamaterial_p.h>
+#include <FramelessHelper/Core/private/scopeguard_p.h>
+#include <QtTest/qtest.h>
+#include <QtGui/qimage.h>
+#include <QtGui/private/qmemrotate_p.h>
+#include <utility>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+static constexpr const qreal kBlurRadius = 16.0;
+
+[[nodiscard]] static inline QImage createImage(const QSize &size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y != image.height(); ++y) {
+        auto line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x != image.width(); ++x) {
+            line[x] = qRgb((x * 7), (y * 13), (x ^ y));
+        }
+    }
+    return image;
+}
+
+class tst_Bench_MicaBlur : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void columnPass_data();
+    void columnPass();
+    void columnPassMemory_data();
+    void columnPassMemory();
+    void qualityTiers_data();
+    void qualityTiers();
+    void qualityTiersMemory_data();
+    void qualityTiersMemory();
+    void bands_data();
+    void bands();
+};
+
+void tst_Bench_MicaBlur::columnPass_data()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<bool>("rotate");
+
+    QTest::newRow("1080p in place") << QSize(1920, 1080) << false;
+    QTest::newRow("1080p rotated") << QSize(1920, 1080) << true;
+    QTest::newRow("1440p in place") << QSize(2560, 1440) << false;
+    QTest::newRow("1440p rotated") << QSize(2560, 1440) << true;
+    QTest::newRow("4K in place") << QSize(3840, 2160) << false;
+    QTest::newRow("4K rotated") << QSize(3840, 2160) << true;
+}
+
+void tst_Bench_MicaBlur::columnPass()
+{
+    QFETCH(QSize, size);
+    QFETCH(bool, rotate);
+
+    const QImage image = createImage(size);
+    // The rotated variant is the old code path: the transposed blur rotates
+    // the image once for the vertical pass, rotating it back costs another sweep.
+    QImage result(size, image.format());
+    QBENCHMARK {
+        if (rotate) {
+            const QImage transposed = MicaMaterialPrivate::blurredImage(image, kBlurRadius, true);
+            qt_memrotate90(reinterpret_cast<const quint32 *>(transposed.constBits()),
+                           transposed.width(), transposed.height(), transposed.bytesPerLine(),
+                           reinterpret_cast<quint32 *>(result.bits()), result.bytesPerLine());
+        } else {
+            result = MicaMaterialPrivate::blurredImage(image, kBlurRadius);
+        }
+    }
+    QCOMPARE(result.size(), size);
+}
+
+void tst_Bench_MicaBlur::columnPassMemory_data()
+{
+    columnPass_data();
+}
+
+void tst_Bench_MicaBlur::columnPassMemory()
+{
+    QFETCH(QSize, size);
+    QFETCH(bool, rotate);
+
+    // Both paths blur the same buffer, the only difference in the peak
+    // is the temporary frame the rotated path needs for the vertical pass.
+    const QImage image = createImage(size);
+    const QImage result = MicaMaterialPrivate::blurredImage(image, kBlurRadius, rotate);
+    QVERIFY(!result.isNull());
+    QTest::setBenchmarkResult((rotate ? qreal(result.sizeInBytes()) : qreal(0)), QTest::BytesAllocated);
+}
+
+void tst_Bench_MicaBlur::qualityTiers_data()
+{
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("scaleFactor");
+
+    // The old code only halved the image once before blurring it. The others are
+    // the scale factors of MicaQuality::High, MicaQuality::Balanced and MicaQuality::Fast.
+    static constexpr const std::pair<const char *, int> tiers[] = {
+        { "half", 2 }, { "high", 4 }, { "balanced", 8 }, { "fast", 16 }
+    };
+    for (auto &&[name, scaleFactor] : tiers) {
+        QTest::addRow("1080p %s", name) << QSize(1920, 1080) << scaleFactor;
+        QTest::addRow("4K %s", name) << QSize(3840, 2160) << scaleFactor;
+    }
+}
+
+void tst_Bench_MicaBlur::qualityTiers()
+{
+    QFETCH(QSize, size);
+    QFETCH(int, scaleFactor);
+
+    const QImage image = createImage(size);
+    QImage result = {};
+    QBENCHMARK {
+        result = MicaMaterialPrivate::blurredWallpaper(image, scaleFactor);
+    }
+    QVERIFY(!result.isNull());
+}
+
+void tst_Bench_MicaBlur::qualityTiersMemory_data()
+{
+    qualityTiers_data();
+}
+
+void tst_Bench_MicaBlur::qualityTiersMemory()
+{
+    QFETCH(QSize, size);
+    QFETCH(int, scaleFactor);
+
+    // The blurred image is what stays resident for as long as the wallpaper is in use.
+    const QImage result = MicaMaterialPrivate::blurredWallpaper(createImage(size), scaleFactor);
+    QVERIFY(!result.isNull());
+    QTest::setBenchmarkResult(qreal(result.sizeInBytes()), QTest::BytesAllocated);
+}
+
+void tst_Bench_MicaBlur::bands_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+void tst_Bench_MicaBlur::bands()
+{
+    QFETCH(int, threadCount);
+
+    const QImage image = createImage(QSize(3840, 2160));
+    MicaMaterial::setBlurThreadCount(1);
+    const QImage expected = MicaMaterialPrivate::blurredImage(image, kBlurRadius);
+    MicaMaterial::setBlurThreadCount(threadCount);
+    const auto cleanup = qScopeGuard([](){ MicaMaterial::setBlurThreadCount(0); });
+    QImage result = {};
+    QBENCHMARK {
+        result = MicaMaterialPrivate::blurredImage(image, kBlurRadius);
+    }
+    // Splitting the work into bands must not change a single pixel.
+    QCOMPARE(result, expected);
+}
+
+QTEST_GUILESS_MAIN(tst_Bench_MicaBlur)
+
+#include "tst_bench_micablur.moc"
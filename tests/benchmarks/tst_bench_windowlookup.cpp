@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <FramelessHelper/Widgets/framelesswidgetshelper.h>
+#include <FramelessHelper/Widgets/private/framelesswidgetshelper_p.h>
+#include <QtTest/qtest.h>
+#include <QtCore/qhash.h>
+#include <QtWidgets/qwidget.h>
+#include <memory>
+#include <vector>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+static constexpr const int kWindowCount = 100;
+
+class tst_Bench_WindowLookup : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void lookup_data();
+    void lookup();
+
+private:
+    std::vector<std::unique_ptr<QWidget>> m_windows = {};
+    QList<const FramelessWidgetsHelperPrivate *> m_helpers = {};
+};
+
+void tst_Bench_WindowLookup::initTestCase()
+{
+    for (int i = 0; i != kWindowCount; ++i) {
+        auto window = std::make_unique<QWidget>();
+        FramelessWidgetsHelper * const helper = FramelessWidgetsHelper::get(window.get());
+        QVERIFY(helper);
+        helper->extendsContentIntoTitleBar();
+        const FramelessWidgetsHelperPrivate * const d = FramelessWidgetsHelperPrivate::get(helper);
+        QVERIFY(d->getWindowData());
+        m_helpers.append(d);
+        m_windows.push_back(std::move(window));
+    }
+}
+
+void tst_Bench_WindowLookup::cleanupTestCase()
+{
+    m_helpers.clear();
+    m_windows.clear();
+}
+
+void tst_Bench_WindowLookup::lookup_data()
+{
+    QTest::addColumn<bool>("byWinId");
+
+    QTest::newRow("winId and hash") << true;
+    QTest::newRow("cached") << false;
+}
+
+// Each iteration is one event for every window.
+void tst_Bench_WindowLookup::lookup()
+{
+    QFETCH(bool, byWinId);
+
+    int found = 0;
+    if (byWinId) {
+        // What every lookup used to do: ask the window for its native handle and hash it.
+        QHash<WId, int> registry = {};
+        for (int i = 0; i != kWindowCount; ++i) {
+            registry.insert(m_windows.at(i)->winId(), i);
+        }
+        QBENCHMARK {
+            for (auto &&window : std::as_const(m_windows)) {
+                found += (registry.contains(window->winId()) ? 1 : 0);
+            }
+        }
+    } else {
+        QBENCHMARK {
+            for (auto &&helper : std::as_const(m_helpers)) {
+                found += (helper->getWindowData() ? 1 : 0);
+            }
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+QTEST_MAIN(tst_Bench_WindowLookup)
+
+#include "tst_bench_windowlookup.moc"